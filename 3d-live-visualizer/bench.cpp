@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Headless benchmark for the visualizer engines: links src/engines directly,
+// no tokio/warp server or browser involved.
+extern "C" {
+    void transform_c(const float* vertices, float* output, int count, float angle);
+    void transform_cpp(const float* vertices, float* output, int count, float angle);
+    void generate_torus_cpp(float* output, int num_vertices, int num_threads);
+}
+
+typedef void (*TransformFn)(const float*, float*, int, float);
+
+struct Engine {
+    const char* name;
+    TransformFn transform;
+};
+
+struct FrameStats {
+    double vertices_per_sec;
+    double p50_us, p99_us, max_us;
+    double checksum;
+};
+
+static double percentile(std::vector<double>& sorted, double p) {
+    size_t idx = (size_t)std::ceil(p / 100.0 * sorted.size());
+    return sorted[std::min(sorted.size() - 1, idx > 0 ? idx - 1 : 0)];
+}
+
+static FrameStats run_engine(const Engine& e, const std::vector<float>& vertices, std::vector<float>& output,
+                             int count, int frames) {
+    // Warm-up
+    for (int frame = 0; frame < 10; frame++) {
+        e.transform(vertices.data(), output.data(), count, frame * 0.02f);
+    }
+
+    std::vector<double> frame_us(frames);
+    double checksum = 0.0;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (int frame = 0; frame < frames; frame++) {
+        auto t0 = std::chrono::high_resolution_clock::now();
+        e.transform(vertices.data(), output.data(), count, frame * 0.02f);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        frame_us[frame] = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        checksum += output[(frame * 7919) % (count * 3)];
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed_s = std::chrono::duration<double>(end - start).count();
+
+    std::sort(frame_us.begin(), frame_us.end());
+    return { (double)count * frames / elapsed_s,
+             percentile(frame_us, 50.0), percentile(frame_us, 99.0), frame_us.back(), checksum };
+}
+
+int main() {
+    const int max_vertices = 1000000;  // Same cap as the server
+    const int vertex_counts[] = { 10000, 50000, 100000, 250000, 500000, max_vertices };
+    const int frames = 200;
+    const Engine engines[] = { { "c", transform_c }, { "cpp", transform_cpp } };
+
+    std::vector<float> vertices(max_vertices * 3);
+    std::vector<float> out_c(max_vertices * 3);
+    std::vector<float> out_cpp(max_vertices * 3);
+    int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    bool all_match = true;
+
+    std::printf("%-8s %-8s %-16s %-10s %-10s %-10s %s\n",
+                "engine", "vertices", "vertices/sec", "p50_us", "p99_us", "max_us", "checksum");
+
+    for (int count : vertex_counts) {
+        generate_torus_cpp(vertices.data(), count, threads);
+
+        for (const Engine& e : engines) {
+            std::vector<float>& out = (e.transform == transform_c) ? out_c : out_cpp;
+            FrameStats s = run_engine(e, vertices, out, count, frames);
+            std::printf("%-8s %-8d %-16.0f %-10.1f %-10.1f %-10.1f %.6f\n",
+                        e.name, count, s.vertices_per_sec, s.p50_us, s.p99_us, s.max_us, s.checksum);
+        }
+
+        // Both engines ran the same final frame: outputs must agree
+        float max_diff = 0.0f;
+        for (int i = 0; i < count * 3; i++) {
+            max_diff = std::max(max_diff, std::fabs(out_c[i] - out_cpp[i]));
+        }
+        bool match = max_diff <= 1e-5f;
+        all_match = all_match && match;
+        std::printf("match vertices=%d max_abs_diff=%g status=%s\n", count, max_diff, match ? "OK" : "MISMATCH");
+    }
+
+    return all_match ? 0 : 1;
+}
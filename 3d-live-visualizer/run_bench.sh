@@ -0,0 +1,16 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+
+echo "Building live-engines-bench..."
+docker build -f "$ROOT_DIR/Dockerfile.bench" -t live-engines-bench "$ROOT_DIR" >/dev/null
+
+# Extract ASM
+mkdir -p "$ROOT_DIR/asm"
+docker run --rm live-engines-bench objdump -d /bench/bench > "$ROOT_DIR/asm/live-engines.asm" 2>/dev/null || true
+
+echo
+echo "Headless engine benchmark: transform_c vs transform_cpp, 200 frames per vertex count"
+echo
+docker run --rm live-engines-bench
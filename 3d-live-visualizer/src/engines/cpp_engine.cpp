@@ -1,6 +1,12 @@
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <thread>
 #include <vector>
 
+// Values per bit-packing block; each block carries one width byte.
+constexpr int ENCODE_BLOCK = 128;
+
 extern "C" {
     void transform_cpp(const float* vertices, float* output, int count, float angle) {
         float cos_a = std::cos(angle);
@@ -23,4 +29,84 @@ extern "C" {
             output[i * 3 + 2] = z2;
         }
     }
+
+    // Parallel mesh engine: the same torus as generate_torus in main.rs, split
+    // into contiguous vertex ranges, one per thread.
+    void generate_torus_cpp(float* output, int num_vertices, int num_threads) {
+        const float pi = 3.14159265358979323846f;
+        const float r1 = 2.0f;
+        const float r2 = 0.5f;
+
+        auto build = [=](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                float u = ((float)i / (float)num_vertices) * pi * 2.0f;
+                float v = ((float)i * 0.1f) * pi * 2.0f;
+                output[i * 3 + 0] = (r1 + r2 * std::cos(v)) * std::cos(u);
+                output[i * 3 + 1] = (r1 + r2 * std::cos(v)) * std::sin(u);
+                output[i * 3 + 2] = r2 * std::sin(v);
+            }
+        };
+
+        num_threads = std::max(1, std::min(num_threads, num_vertices / 4096));
+        int chunk = (num_vertices + num_threads - 1) / num_threads;
+        std::vector<std::thread> workers;
+        for (int t = 1; t < num_threads; t++) {
+            workers.emplace_back(build, std::min(t * chunk, num_vertices), std::min((t + 1) * chunk, num_vertices));
+        }
+        build(0, std::min(chunk, num_vertices));
+        for (auto& w : workers) w.join();
+    }
+
+    // Worst-case size of encode_delta_cpp output for `count` vertices.
+    int encode_bound_cpp(int count) {
+        int n = count * 3;
+        return n * 2 + (n + ENCODE_BLOCK - 1) / ENCODE_BLOCK;
+    }
+
+    // Quantized delta stream for the websocket clients:
+    //   1. quantize each coordinate to 16 bits over [-extent, extent]
+    //   2. zigzag delta against the previous frame (`prev` is updated in place;
+    //      a keyframe encodes against zero)
+    //   3. bit-pack blocks of ENCODE_BLOCK deltas at the block's widest bit width
+    // Returns the number of bytes written to `out`.
+    int encode_delta_cpp(const float* positions, int count, float extent,
+                         uint16_t* prev, int keyframe, uint8_t* out) {
+        const int n = count * 3;
+        const float scale = 65535.0f / (2.0f * extent);
+        uint16_t zigzag[ENCODE_BLOCK];
+        uint8_t* dst = out;
+
+        for (int base = 0; base < n; base += ENCODE_BLOCK) {
+            int len = std::min(ENCODE_BLOCK, n - base);
+            uint16_t bits = 0;
+
+            for (int i = 0; i < len; i++) {
+                float v = std::min(std::max((positions[base + i] + extent) * scale, 0.0f), 65535.0f);
+                uint16_t q = (uint16_t)(v + 0.5f);
+                uint16_t p = keyframe ? 0 : prev[base + i];
+                int16_t d = (int16_t)(uint16_t)(q - p);
+                uint16_t z = (uint16_t)(((uint16_t)d << 1) ^ (uint16_t)(d >> 15));
+                zigzag[i] = z;
+                bits |= z;
+                prev[base + i] = q;
+            }
+
+            int width = bits ? 32 - __builtin_clz(bits) : 0;
+            *dst++ = (uint8_t)width;
+
+            uint64_t acc = 0;
+            int acc_bits = 0;
+            for (int i = 0; i < len; i++) {
+                acc |= (uint64_t)zigzag[i] << acc_bits;
+                acc_bits += width;
+                while (acc_bits >= 8) {
+                    *dst++ = (uint8_t)acc;
+                    acc >>= 8;
+                    acc_bits -= 8;
+                }
+            }
+            if (acc_bits > 0) *dst++ = (uint8_t)acc;
+        }
+        return (int)(dst - out);
+    }
 }
@@ -0,0 +1,138 @@
+// Zero-copy frame buffer pool for the broadcast path.
+//
+// The frame loop used to allocate a fresh packet per frame and memcpy the
+// whole output buffer into it. Instead, a small ring of reference-counted
+// slots is kept alive for the whole session: the engine writes straight into
+// the next slot nobody is holding, and that same slot is what gets broadcast.
+// A slot becomes free again once every client has dropped its handle. If all
+// slots are still held by slow clients the frame is dropped, never copied.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::Arc;
+
+/// Number of 32-bit words in front of the vertex payload (see `FrameHeader`).
+pub const FRAME_HEADER_WORDS: usize = 7;
+
+/// Payload formats understood by static/index.html.
+pub const FORMAT_RAW: u32 = 0;
+pub const FORMAT_DELTA: u32 = 1;
+pub const FORMAT_KEYFRAME: u32 = 2;
+
+/// Little-endian frame header, one 32-bit word per field.
+pub struct FrameHeader {
+    pub math_elapsed_us: f32,
+    pub encode_elapsed_us: f32,
+    pub format: u32,
+    /// Encoded stream sequence number; clients resync on a gap.
+    pub seq: u32,
+    pub vertex_count: u32,
+    pub payload_bytes: u32,
+    /// Quantization range [-extent, extent] of the encoded formats.
+    pub extent: f32,
+}
+
+impl FrameHeader {
+    pub fn write(&self, header: &mut [f32]) {
+        header[0] = self.math_elapsed_us;
+        header[1] = self.encode_elapsed_us;
+        header[2] = f32::from_bits(self.format);
+        header[3] = f32::from_bits(self.seq);
+        header[4] = f32::from_bits(self.vertex_count);
+        header[5] = f32::from_bits(self.payload_bytes);
+        header[6] = self.extent;
+    }
+}
+
+/// Broadcast channel depth + one slot being written + one in flight per client.
+pub const FRAME_SLOTS: usize = 8;
+
+/// A published frame. Cloning only bumps the reference count.
+#[derive(Clone)]
+pub struct Frame {
+    buf: Arc<Vec<f32>>,
+    words: usize,
+}
+
+impl Frame {
+    pub fn as_bytes(&self) -> &[u8] {
+        unsafe { std::slice::from_raw_parts(self.buf.as_ptr() as *const u8, self.words * 4) }
+    }
+}
+
+/// Counters shared between the frame loop and the websocket clients.
+#[derive(Default)]
+pub struct PoolStats {
+    pub frames: AtomicU64,
+    pub dropped_no_slot: AtomicU64,
+    pub client_lagged: AtomicU64,
+    pub allocations: AtomicU64,
+    pub payload_bytes: AtomicU64,
+    pub encode_us: AtomicU64,
+    /// Bytes copied out of slots on the way to the sockets (one copy per client).
+    pub copy_bytes: AtomicU64,
+}
+
+impl PoolStats {
+    /// Prints per-frame averages since the last call and resets the window.
+    pub fn report(&self) {
+        let frames = self.frames.swap(0, Ordering::Relaxed);
+        if frames == 0 {
+            return; // no clients attached
+        }
+        let per_frame = |v: u64| v as f64 / frames as f64;
+        println!(
+            "frame_pool frames={} dropped_no_slot={} client_lagged={} allocs_per_frame={:.3} bytes_per_frame={:.0} encode_us_per_frame={:.1} copy_bytes_per_frame={:.0}",
+            frames,
+            self.dropped_no_slot.swap(0, Ordering::Relaxed),
+            self.client_lagged.swap(0, Ordering::Relaxed),
+            per_frame(self.allocations.swap(0, Ordering::Relaxed)),
+            per_frame(self.payload_bytes.swap(0, Ordering::Relaxed)),
+            per_frame(self.encode_us.swap(0, Ordering::Relaxed)),
+            per_frame(self.copy_bytes.swap(0, Ordering::Relaxed)),
+        );
+    }
+}
+
+pub struct FramePool {
+    slots: Vec<Arc<Vec<f32>>>,
+    cursor: usize,
+    stats: Arc<PoolStats>,
+}
+
+impl FramePool {
+    pub fn new(num_slots: usize, stats: Arc<PoolStats>) -> Self {
+        let slots = (0..num_slots).map(|_| Arc::new(Vec::new())).collect();
+        FramePool { slots, cursor: 0, stats }
+    }
+
+    /// Finds the next slot no client is holding and sizes it to `words`.
+    /// Buffers only grow, so steady state performs no allocation.
+    pub fn acquire(&mut self, words: usize) -> Option<usize> {
+        for step in 0..self.slots.len() {
+            let idx = (self.cursor + step) % self.slots.len();
+            if let Some(buf) = Arc::get_mut(&mut self.slots[idx]) {
+                if buf.capacity() < words {
+                    buf.reserve_exact(words - buf.len());
+                    self.stats.allocations.fetch_add(1, Ordering::Relaxed);
+                }
+                buf.resize(words, 0.0);
+                self.cursor = (idx + 1) % self.slots.len();
+                return Some(idx);
+            }
+        }
+        self.stats.dropped_no_slot.fetch_add(1, Ordering::Relaxed);
+        None
+    }
+
+    /// Writable view of a slot returned by `acquire`.
+    pub fn slot_mut(&mut self, idx: usize) -> &mut [f32] {
+        Arc::get_mut(&mut self.slots[idx]).expect("slot acquired while shared").as_mut_slice()
+    }
+
+    /// Shares the first `words` words of a slot with the clients.
+    pub fn publish(&mut self, idx: usize, words: usize) -> Frame {
+        self.stats.frames.fetch_add(1, Ordering::Relaxed);
+        self.stats.payload_bytes.fetch_add(((words - FRAME_HEADER_WORDS) * 4) as u64, Ordering::Relaxed);
+        Frame { buf: self.slots[idx].clone(), words }
+    }
+}
@@ -1,15 +1,48 @@
 use std::sync::Arc;
-use std::sync::atomic::{AtomicU8, AtomicU32, Ordering};
+use std::sync::atomic::{AtomicBool, AtomicU8, AtomicU32, AtomicU64, Ordering};
 use tokio::time::{Instant, Duration};
 use warp::Filter;
 use futures_util::{StreamExt, SinkExt};
-use tokio::sync::{broadcast, RwLock};
+use tokio::sync::{broadcast, watch, RwLock};
 use serde::Deserialize;
 
+mod frame_pool;
+use frame_pool::{Frame, FrameHeader, FramePool, PoolStats, FRAME_HEADER_WORDS, FRAME_SLOTS};
+use frame_pool::{FORMAT_DELTA, FORMAT_KEYFRAME, FORMAT_RAW};
+
+mod telemetry;
+use telemetry::{FrameTimings, Telemetry};
+
 // FFI Declarations
 extern "C" {
     fn transform_c(vertices: *const f32, output: *mut f32, count: i32, angle: f32);
     fn transform_cpp(vertices: *const f32, output: *mut f32, count: i32, angle: f32);
+    fn encode_bound_cpp(count: i32) -> i32;
+    fn encode_delta_cpp(positions: *const f32, count: i32, extent: f32, prev: *mut u16, keyframe: i32, out: *mut u8) -> i32;
+    fn generate_torus_cpp(output: *mut f32, num_vertices: i32, num_threads: i32);
+}
+
+// Quantization range of the encoded stream: the torus fits in r1 + r2 = 2.5
+const MESH_EXTENT: f32 = 2.5;
+// Encoded frames between forced keyframes
+const KEYFRAME_INTERVAL: u32 = 120;
+
+// Mesh rebuild paths selectable with the "mesh_path" control message
+const MESH_PATH_BLOCKING: u8 = 0;
+const MESH_PATH_OFFLOOP: u8 = 1;
+
+// Control-plane state shared by the frame loop and every websocket client
+struct SharedState {
+    active_engine: AtomicU8,
+    target_fps: AtomicU32,
+    encoding: AtomicU8, // 0 = raw f32, 1 = quantized delta
+    keyframe_request: AtomicBool,
+    mesh_path: AtomicU8,
+    mesh_generation: AtomicU64,
+    // Latest off-loop rebuild request as (generation, vertex count)
+    mesh_request: watch::Sender<(u64, usize)>,
+    // Readers only hold the lock long enough to clone the Arc (RCU-style)
+    vertices: RwLock<Arc<Vec<f32>>>,
 }
 
 #[derive(Deserialize)]
@@ -32,73 +65,195 @@ fn generate_torus(num_vertices: usize) -> Vec<f32> {
     raw_vertices
 }
 
+// Same torus built by the C++ mesh engine across all cores, without zero-filling first
+fn generate_torus_parallel(num_vertices: usize) -> Vec<f32> {
+    let threads = std::thread::available_parallelism().map_or(1, |n| n.get());
+    let mut raw_vertices = Vec::with_capacity(num_vertices * 3);
+    unsafe {
+        generate_torus_cpp(raw_vertices.as_mut_ptr(), num_vertices as i32, threads as i32);
+        raw_vertices.set_len(num_vertices * 3);
+    }
+    raw_vertices
+}
+
 #[tokio::main]
 async fn main() {
     let max_vertices = 1_000_000;
     let initial_vertices = 50_000;
-    let vertices = Arc::new(RwLock::new(generate_torus(initial_vertices)));
-    let active_engine = Arc::new(AtomicU8::new(0)); 
-    let target_fps = Arc::new(AtomicU32::new(60));
-    let vertex_count = Arc::new(AtomicU32::new(initial_vertices as u32));
+    let (mesh_request, mut mesh_requests) = watch::channel((0u64, initial_vertices));
+    let state = Arc::new(SharedState {
+        active_engine: AtomicU8::new(0),
+        target_fps: AtomicU32::new(60),
+        encoding: AtomicU8::new(0),
+        keyframe_request: AtomicBool::new(false),
+        mesh_path: AtomicU8::new(MESH_PATH_OFFLOOP),
+        mesh_generation: AtomicU64::new(0),
+        mesh_request,
+        vertices: RwLock::new(Arc::new(generate_torus(initial_vertices))),
+    });
 
-    let (tx, _rx) = broadcast::channel::<Vec<u8>>(4); // Smaller buffer for tighter backpressure
+    let (tx, _rx) = broadcast::channel::<Frame>(4); // Smaller buffer for tighter backpressure
     let tx_clone = Arc::new(tx);
+    let pool_stats = Arc::new(PoolStats::default());
+    let telemetry = Arc::new(Telemetry::new());
+
+    // Off-loop mesh builder: one build at a time, always for the latest request,
+    // so a slider drag does not queue up builds that are already stale
+    let state_builder = state.clone();
+    let telemetry_builder = telemetry.clone();
+    tokio::spawn(async move {
+        while mesh_requests.changed().await.is_ok() {
+            let (generation, count) = *mesh_requests.borrow_and_update();
+            telemetry_builder.begin_mesh_rebuild(MESH_PATH_OFFLOOP);
+            let build_start = Instant::now();
+            // Build in parallel on the blocking pool, then swap the pointer
+            match tokio::task::spawn_blocking(move || generate_torus_parallel(count)).await {
+                // A blocking-path rebuild may have superseded this one while it was building
+                Ok(mesh) if state_builder.mesh_generation.load(Ordering::Relaxed) == generation => {
+                    let mut v_lock = state_builder.vertices.write().await;
+                    let old = std::mem::replace(&mut *v_lock, Arc::new(mesh));
+                    drop(v_lock);
+                    drop(old); // freed outside the lock, or by the last frame using it
+                }
+                Ok(_) => {}
+                Err(e) => eprintln!("Mesh build of {} vertices failed: {}", count, e),
+            }
+            telemetry_builder.end_mesh_rebuild(MESH_PATH_OFFLOOP, build_start.elapsed());
+        }
+    });
 
     let tx_task = tx_clone.clone();
-    let engine_task = active_engine.clone();
-    let vertices_task = vertices.clone();
-    let fps_task = target_fps.clone();
-    let count_task = vertex_count.clone();
+    let state_task = state.clone();
+    let stats_task = pool_stats.clone();
+    let telemetry_task = telemetry.clone();
     
     tokio::spawn(async move {
         let mut angle: f32 = 0.0;
-        // Pre-allocate output buffer to max size to avoid reallocations
-        let mut output_buffer = vec![0.0f32; max_vertices * 3];
+        // Engines write straight into reference-counted broadcast slots
+        let mut pool = FramePool::new(FRAME_SLOTS, stats_task.clone());
+        let mut last_report = Instant::now();
+        // Encoder state: transform output, previous quantized frame, stream position
+        let mut positions_buffer: Vec<f32> = Vec::new();
+        let mut prev_quantized: Vec<u16> = Vec::new();
+        let mut seq: u32 = 0;
+        let mut last_frame_start: Option<Instant> = None;
         
         loop {
-            let current_count = count_task.load(Ordering::Relaxed) as usize;
-            let current_engine = engine_task.load(Ordering::Relaxed);
-            let current_fps = fps_task.load(Ordering::Relaxed);
-            
-            let v_lock = vertices_task.read().await;
-            let math_start = Instant::now();
+            let current_engine = state_task.active_engine.load(Ordering::Relaxed);
+            let current_fps = state_task.target_fps.load(Ordering::Relaxed);
             
-            match current_engine {
-                0 => { // Rust
-                    let cos_a = angle.cos();
-                    let sin_a = angle.sin();
-                    for i in 0..current_count {
-                        let px = v_lock[i * 3 + 0];
-                        let py = v_lock[i * 3 + 1];
-                        let pz = v_lock[i * 3 + 2];
-                        output_buffer[i * 3 + 0] = px * cos_a + pz * sin_a;
-                        output_buffer[i * 3 + 1] = py * cos_a - (-px * sin_a + pz * cos_a) * sin_a;
-                        output_buffer[i * 3 + 2] = py * sin_a + (-px * sin_a + pz * cos_a) * cos_a;
+            let mut timings = FrameTimings::default();
+            let frame_start = Instant::now();
+            if let (Some(last), true) = (last_frame_start, current_fps > 0) {
+                let interval = frame_start - last;
+                let target = Duration::from_micros(1_000_000 / current_fps as u64);
+                timings.pacing_jitter = Some(if interval > target { interval - target } else { target - interval });
+            }
+            last_frame_start = Some(frame_start);
+
+            let rebuild_before = telemetry_task.mesh_rebuild_in_progress();
+            // Snapshot of the current mesh; a concurrent rebuild publishes a new Arc
+            let mesh = state_task.vertices.read().await.clone();
+            timings.lock_wait = frame_start.elapsed();
+            timings.mesh_rebuild = rebuild_before.or(telemetry_task.mesh_rebuild_in_progress());
+            let current_count = mesh.len() / 3;
+
+            let current_encoding = state_task.encoding.load(Ordering::Relaxed);
+            let payload_words = if current_encoding == 0 {
+                current_count * 3
+            } else {
+                (unsafe { encode_bound_cpp(current_count as i32) } as usize + 3) / 4
+            };
+
+            // No free slot means every buffer is still held by slow clients: drop the frame
+            if let Some(slot) = pool.acquire(FRAME_HEADER_WORDS + payload_words) {
+                let (header, payload) = pool.slot_mut(slot).split_at_mut(FRAME_HEADER_WORDS);
+                // Raw frames are transformed straight into the slot; encoded ones go through a scratch buffer
+                let output_buffer: &mut [f32] = if current_encoding == 0 {
+                    &mut payload[..current_count * 3]
+                } else {
+                    positions_buffer.resize(current_count * 3, 0.0);
+                    &mut positions_buffer[..]
+                };
+                let math_start = Instant::now();
+
+                match current_engine {
+                    0 => { // Rust
+                        let cos_a = angle.cos();
+                        let sin_a = angle.sin();
+                        for i in 0..current_count {
+                            let px = mesh[i * 3 + 0];
+                            let py = mesh[i * 3 + 1];
+                            let pz = mesh[i * 3 + 2];
+                            output_buffer[i * 3 + 0] = px * cos_a + pz * sin_a;
+                            output_buffer[i * 3 + 1] = py * cos_a - (-px * sin_a + pz * cos_a) * sin_a;
+                            output_buffer[i * 3 + 2] = py * sin_a + (-px * sin_a + pz * cos_a) * cos_a;
+                        }
                     }
+                    1 => unsafe { transform_c(mesh.as_ptr(), output_buffer.as_mut_ptr(), current_count as i32, angle); }
+                    2 => unsafe { transform_cpp(mesh.as_ptr(), output_buffer.as_mut_ptr(), current_count as i32, angle); }
+                    _ => {}
                 }
-                1 => unsafe { transform_c(v_lock.as_ptr(), output_buffer.as_mut_ptr(), current_count as i32, angle); }
-                2 => unsafe { transform_cpp(v_lock.as_ptr(), output_buffer.as_mut_ptr(), current_count as i32, angle); }
-                _ => {}
-            }
-            let math_elapsed_us = math_start.elapsed().as_micros() as f32;
-            drop(v_lock);
-
-            if tx_task.receiver_count() > 0 {
-                let mut packet = Vec::with_capacity(4 + current_count * 3 * 4);
-                packet.extend_from_slice(&math_elapsed_us.to_ne_bytes());
-                unsafe {
-                    let vertex_bytes = std::slice::from_raw_parts(output_buffer.as_ptr() as *const u8, current_count * 3 * 4);
-                    packet.extend_from_slice(vertex_bytes);
+                timings.math = math_start.elapsed();
+                let math_elapsed_us = timings.math.as_micros() as f32;
+                drop(mesh);
+                let packet_start = Instant::now();
+
+                let mut frame_header = FrameHeader {
+                    math_elapsed_us,
+                    encode_elapsed_us: 0.0,
+                    format: FORMAT_RAW,
+                    seq,
+                    vertex_count: current_count as u32,
+                    payload_bytes: (current_count * 3 * 4) as u32,
+                    extent: MESH_EXTENT,
+                };
+
+                if current_encoding != 0 {
+                    let keyframe = prev_quantized.len() != current_count * 3
+                        || seq % KEYFRAME_INTERVAL == 0
+                        || state_task.keyframe_request.swap(false, Ordering::Relaxed);
+                    prev_quantized.resize(current_count * 3, 0);
+
+                    let encode_start = Instant::now();
+                    let bytes = unsafe {
+                        encode_delta_cpp(output_buffer.as_ptr(), current_count as i32, MESH_EXTENT,
+                                         prev_quantized.as_mut_ptr(), keyframe as i32, payload.as_mut_ptr() as *mut u8)
+                    };
+                    let encode_elapsed = encode_start.elapsed();
+                    timings.encode = Some(encode_elapsed);
+                    frame_header.encode_elapsed_us = encode_elapsed.as_micros() as f32;
+                    frame_header.format = if keyframe { FORMAT_KEYFRAME } else { FORMAT_DELTA };
+                    frame_header.payload_bytes = bytes as u32;
+                    stats_task.encode_us.fetch_add(frame_header.encode_elapsed_us as u64, Ordering::Relaxed);
+                    seq = seq.wrapping_add(1);
+                } else {
+                    prev_quantized.clear();
                 }
-                // If channel is full, this will fail - providing natural backpressure
-                let _ = tx_task.send(packet);
+                frame_header.write(header);
+
+                if tx_task.receiver_count() > 0 {
+                    // If channel is full, the oldest frame is overwritten - lagging clients skip ahead
+                    let words = FRAME_HEADER_WORDS + (frame_header.payload_bytes as usize + 3) / 4;
+                    let _ = tx_task.send(pool.publish(slot, words));
+                }
+                timings.packet = packet_start.elapsed().saturating_sub(timings.encode.unwrap_or_default());
+            } else {
+                drop(mesh);
+                timings.dropped = true;
+            }
+            telemetry_task.record(current_engine, &timings);
+
+            if last_report.elapsed() >= Duration::from_secs(1) {
+                stats_task.report();
+                last_report = Instant::now();
             }
 
             angle += 0.02;
             
             if current_fps > 0 {
                 let frame_micros = 1_000_000 / current_fps as u64;
-                let loop_elapsed = math_start.elapsed();
+                let loop_elapsed = frame_start.elapsed();
                 if loop_elapsed < Duration::from_micros(frame_micros) {
                     tokio::time::sleep(Duration::from_micros(frame_micros) - loop_elapsed).await;
                 }
@@ -109,31 +264,50 @@ async fn main() {
         }
     });
 
-    let state = Arc::new((active_engine, target_fps, vertex_count, vertices));
     let state_filter = warp::any().map(move || state.clone());
     let tx_ws = tx_clone.clone();
+    let stats_ws = pool_stats.clone();
+    let telemetry_ws = telemetry.clone();
 
     let ws_route = warp::path("ws")
         .and(warp::ws())
         .and(state_filter)
-        .map(move |ws: warp::ws::Ws, state: Arc<(Arc<AtomicU8>, Arc<AtomicU32>, Arc<AtomicU32>, Arc<RwLock<Vec<f32>>>)>| {
+        .map(move |ws: warp::ws::Ws, state: Arc<SharedState>| {
             let tx = tx_ws.clone();
+            let stats = stats_ws.clone();
+            let telemetry = telemetry_ws.clone();
             ws.on_upgrade(move |socket| async move {
                 let (mut ws_tx, mut ws_rx) = socket.split();
                 let mut rx = tx.subscribe();
+                // A new client has no previous frame to apply deltas to
+                state.keyframe_request.store(true, Ordering::Relaxed);
                 let state_inner = state.clone();
+                let telemetry_inner = telemetry.clone();
                 
                 tokio::spawn(async move {
                     while let Some(Ok(msg)) = ws_rx.next().await {
                         if let Ok(text) = msg.to_str() {
                             if let Ok(cmd) = serde_json::from_str::<ControlMsg>(text) {
                                 match cmd.r#type.as_str() {
-                                    "engine" => state_inner.0.store(cmd.value as u8, Ordering::Relaxed),
-                                    "fps" => state_inner.1.store(cmd.value, Ordering::Relaxed),
+                                    "engine" => state_inner.active_engine.store(cmd.value as u8, Ordering::Relaxed),
+                                    "fps" => state_inner.target_fps.store(cmd.value, Ordering::Relaxed),
+                                    "encoding" => state_inner.encoding.store(cmd.value as u8, Ordering::Relaxed),
+                                    "mesh_path" => state_inner.mesh_path.store(cmd.value as u8, Ordering::Relaxed),
                                     "vertices" => {
-                                        state_inner.2.store(cmd.value, Ordering::Relaxed);
-                                        let mut v_lock = state_inner.3.write().await;
-                                        *v_lock = generate_torus(cmd.value as usize);
+                                        let count = cmd.value.min(max_vertices as u32) as usize;
+                                        let generation = state_inner.mesh_generation.fetch_add(1, Ordering::Relaxed) + 1;
+                                        if state_inner.mesh_path.load(Ordering::Relaxed) == MESH_PATH_BLOCKING {
+                                            // Legacy path: the frame loop waits on the lock for the whole rebuild
+                                            telemetry_inner.begin_mesh_rebuild(MESH_PATH_BLOCKING);
+                                            let build_start = Instant::now();
+                                            let mut v_lock = state_inner.vertices.write().await;
+                                            *v_lock = Arc::new(generate_torus(count));
+                                            drop(v_lock);
+                                            telemetry_inner.end_mesh_rebuild(MESH_PATH_BLOCKING, build_start.elapsed());
+                                        } else {
+                                            // Hand off to the builder task; a newer request replaces a pending one
+                                            state_inner.mesh_request.send_replace((generation, count));
+                                        }
                                     },
                                     _ => {}
                                 }
@@ -142,13 +316,34 @@ async fn main() {
                     }
                 });
 
-                while let Ok(data) = rx.recv().await {
-                    if ws_tx.send(warp::ws::Message::binary(data)).await.is_err() { break; }
+                loop {
+                    let frame = match rx.recv().await {
+                        Ok(frame) => frame,
+                        // Slow client: skip the frames it missed instead of disconnecting
+                        Err(broadcast::error::RecvError::Lagged(n)) => {
+                            stats.client_lagged.fetch_add(n, Ordering::Relaxed);
+                            telemetry.record_lagged(state.active_engine.load(Ordering::Relaxed), n);
+                            state.keyframe_request.store(true, Ordering::Relaxed);
+                            continue;
+                        }
+                        Err(broadcast::error::RecvError::Closed) => break,
+                    };
+                    // warp 0.3 messages own a Vec<u8>, so the socket write is the only copy left
+                    let bytes = frame.as_bytes();
+                    stats.copy_bytes.fetch_add(bytes.len() as u64, Ordering::Relaxed);
+                    let msg = warp::ws::Message::binary(bytes.to_vec());
+                    drop(frame);
+                    if ws_tx.send(msg).await.is_err() { break; }
                 }
             })
         });
 
-    let routes = ws_route.or(warp::get().and(warp::path::end()).and(warp::fs::file("static/index.html")))
+    // Per-engine stage latency percentiles: curl http://localhost:8080/stats
+    let stats_route = warp::path("stats")
+        .and(warp::path::end())
+        .map(move || warp::reply::json(&telemetry.snapshot()));
+
+    let routes = ws_route.or(stats_route).or(warp::get().and(warp::path::end()).and(warp::fs::file("static/index.html")))
                          .or(warp::path("static").and(warp::fs::dir("static")));
 
     println!("3D LIVE POLYGLOT SESSION STARTED");
@@ -0,0 +1,243 @@
+// Per-stage frame loop telemetry.
+//
+// Every frame the loop timestamps its stages with Instant (vDSO clock, no
+// syscall) and records the durations into log-linear HDR-style histograms,
+// one set per engine, so transform_c / transform_cpp / Rust can be compared
+// under the same load. Mesh rebuilds are tracked per rebuild path so the
+// frame-time spike of each can be compared. GET /stats returns p50/p99/p999
+// per stage as JSON.
+
+use serde_json::{json, Value};
+use std::sync::atomic::{AtomicU32, AtomicU64, Ordering};
+use std::sync::Mutex;
+use std::time::Duration;
+
+pub const ENGINE_NAMES: [&str; 3] = ["rust", "c", "cpp"];
+pub const MESH_PATH_NAMES: [&str; 2] = ["blocking", "offloop"];
+
+// 2^SUB_BUCKET_BITS linear sub-buckets per power of two: ~3% relative error
+const SUB_BUCKET_BITS: u32 = 5;
+const SUB_BUCKETS: usize = 1 << SUB_BUCKET_BITS;
+const HALF_SUB_BUCKETS: usize = SUB_BUCKETS / 2;
+const NUM_BUCKETS: usize = (64 - SUB_BUCKET_BITS as usize + 2) * HALF_SUB_BUCKETS;
+
+/// Log-linear histogram of nanosecond values with a fixed memory footprint.
+pub struct Histogram {
+    counts: Vec<u64>,
+    total: u64,
+    sum: u64,
+    max: u64,
+}
+
+impl Histogram {
+    pub fn new() -> Self {
+        Histogram { counts: vec![0; NUM_BUCKETS], total: 0, sum: 0, max: 0 }
+    }
+
+    fn bucket_of(v: u64) -> usize {
+        if v < SUB_BUCKETS as u64 {
+            return v as usize;
+        }
+        let shift = 63 - v.leading_zeros() - (SUB_BUCKET_BITS - 1);
+        shift as usize * HALF_SUB_BUCKETS + (v >> shift) as usize
+    }
+
+    fn value_of(idx: usize) -> u64 {
+        if idx < SUB_BUCKETS {
+            return idx as u64;
+        }
+        let shift = idx / HALF_SUB_BUCKETS - 1;
+        let mantissa = (idx - shift * HALF_SUB_BUCKETS) as u64;
+        // Midpoint of the bucket's range
+        (mantissa << shift) + ((1u64 << shift) >> 1)
+    }
+
+    pub fn record(&mut self, d: Duration) {
+        let ns = d.as_nanos().min(u64::MAX as u128) as u64;
+        self.counts[Self::bucket_of(ns)] += 1;
+        self.total += 1;
+        self.sum = self.sum.saturating_add(ns);
+        self.max = self.max.max(ns);
+    }
+
+    pub fn percentile_ns(&self, p: f64) -> u64 {
+        if self.total == 0 {
+            return 0;
+        }
+        let target = ((p / 100.0) * self.total as f64).ceil().max(1.0) as u64;
+        let mut seen = 0;
+        for (idx, &c) in self.counts.iter().enumerate() {
+            seen += c;
+            if seen >= target {
+                return Self::value_of(idx).min(self.max);
+            }
+        }
+        self.max
+    }
+
+    pub fn summary(&self) -> Value {
+        let us = |ns: u64| ns as f64 / 1000.0;
+        json!({
+            "count": self.total,
+            "mean_us": if self.total > 0 { us(self.sum / self.total) } else { 0.0 },
+            "p50_us": us(self.percentile_ns(50.0)),
+            "p99_us": us(self.percentile_ns(99.0)),
+            "p999_us": us(self.percentile_ns(99.9)),
+            "max_us": us(self.max),
+        })
+    }
+}
+
+/// Stage durations of one frame, recorded under a single lock acquisition.
+#[derive(Default)]
+pub struct FrameTimings {
+    pub lock_wait: Duration,
+    pub math: Duration,
+    pub encode: Option<Duration>,
+    pub packet: Duration,
+    /// |actual frame interval - 1/target_fps|, only when the FPS is capped
+    pub pacing_jitter: Option<Duration>,
+    pub dropped: bool,
+    /// Mesh rebuild path in flight while this frame waited for the mesh
+    pub mesh_rebuild: Option<u8>,
+}
+
+struct EngineStats {
+    frames: u64,
+    dropped_no_slot: u64,
+    lock_wait: Histogram,
+    math: Histogram,
+    encode: Histogram,
+    packet: Histogram,
+    pacing_jitter: Histogram,
+}
+
+impl EngineStats {
+    fn new() -> Self {
+        EngineStats {
+            frames: 0,
+            dropped_no_slot: 0,
+            lock_wait: Histogram::new(),
+            math: Histogram::new(),
+            encode: Histogram::new(),
+            packet: Histogram::new(),
+            pacing_jitter: Histogram::new(),
+        }
+    }
+}
+
+struct MeshStats {
+    rebuilds: u64,
+    build: Histogram,
+    /// Frame loop lock wait while a rebuild is in flight: the frame-time spike
+    frame_lock_wait: Histogram,
+}
+
+/// Shared between the frame loop (once per frame), the websocket clients and
+/// the /stats route; the lock is only held to bump a few counters.
+pub struct Telemetry {
+    engines: Mutex<Vec<EngineStats>>,
+    client_lagged: [AtomicU64; 3],
+    mesh: Mutex<Vec<MeshStats>>,
+    /// Rebuilds in flight per mesh path; clients can rebuild concurrently
+    rebuilds_in_flight: [AtomicU32; MESH_PATH_NAMES.len()],
+}
+
+impl Telemetry {
+    pub fn new() -> Self {
+        Telemetry {
+            engines: Mutex::new(ENGINE_NAMES.iter().map(|_| EngineStats::new()).collect()),
+            client_lagged: Default::default(),
+            mesh: Mutex::new(MESH_PATH_NAMES.iter().map(|_| MeshStats {
+                rebuilds: 0,
+                build: Histogram::new(),
+                frame_lock_wait: Histogram::new(),
+            }).collect()),
+            rebuilds_in_flight: Default::default(),
+        }
+    }
+
+    pub fn begin_mesh_rebuild(&self, path: u8) {
+        if let Some(c) = self.rebuilds_in_flight.get(path as usize) {
+            c.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+
+    pub fn end_mesh_rebuild(&self, path: u8, build: Duration) {
+        if let Some(c) = self.rebuilds_in_flight.get(path as usize) {
+            c.fetch_sub(1, Ordering::Relaxed);
+        }
+        if let Some(m) = self.mesh.lock().unwrap().get_mut(path as usize) {
+            m.rebuilds += 1;
+            m.build.record(build);
+        }
+    }
+
+    /// A mesh path with a rebuild in flight, lowest index first so the
+    /// blocking path, which stalls the frame loop, wins when both are running
+    pub fn mesh_rebuild_in_progress(&self) -> Option<u8> {
+        self.rebuilds_in_flight
+            .iter()
+            .position(|c| c.load(Ordering::Relaxed) > 0)
+            .map(|p| p as u8)
+    }
+
+    /// Frames a lagging websocket client skipped while `engine` was active.
+    pub fn record_lagged(&self, engine: u8, frames: u64) {
+        if let Some(c) = self.client_lagged.get(engine as usize) {
+            c.fetch_add(frames, Ordering::Relaxed);
+        }
+    }
+
+    pub fn record(&self, engine: u8, t: &FrameTimings) {
+        if let Some(path) = t.mesh_rebuild {
+            if let Some(m) = self.mesh.lock().unwrap().get_mut(path as usize) {
+                m.frame_lock_wait.record(t.lock_wait);
+            }
+        }
+        let mut engines = self.engines.lock().unwrap();
+        let Some(e) = engines.get_mut(engine as usize) else { return };
+        e.frames += 1;
+        e.lock_wait.record(t.lock_wait);
+        if let Some(jitter) = t.pacing_jitter {
+            e.pacing_jitter.record(jitter);
+        }
+        if t.dropped {
+            e.dropped_no_slot += 1;
+            return;
+        }
+        e.math.record(t.math);
+        if let Some(encode) = t.encode {
+            e.encode.record(encode);
+        }
+        e.packet.record(t.packet);
+    }
+
+    pub fn snapshot(&self) -> Value {
+        let mut engines = serde_json::Map::new();
+        for (i, e) in self.engines.lock().unwrap().iter().enumerate() {
+            if e.frames == 0 {
+                continue;
+            }
+            engines.insert(ENGINE_NAMES[i].to_string(), json!({
+                "frames": e.frames,
+                "dropped_no_slot": e.dropped_no_slot,
+                "client_lagged": self.client_lagged[i].load(Ordering::Relaxed),
+                "lock_wait": e.lock_wait.summary(),
+                "math": e.math.summary(),
+                "encode": e.encode.summary(),
+                "packet": e.packet.summary(),
+                "pacing_jitter": e.pacing_jitter.summary(),
+            }));
+        }
+        let mut mesh = serde_json::Map::new();
+        for (i, m) in self.mesh.lock().unwrap().iter().enumerate() {
+            mesh.insert(MESH_PATH_NAMES[i].to_string(), json!({
+                "rebuilds": m.rebuilds,
+                "build": m.build.summary(),
+                "frame_lock_wait": m.frame_lock_wait.summary(),
+            }));
+        }
+        json!({ "engines": engines, "mesh_rebuild": mesh })
+    }
+}
@@ -1,13 +1,35 @@
+#include <algorithm>
+#include <cerrno>
 #include <iostream>
 #include <vector>
 #include <chrono>
+#include <thread>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sched.h>
 #include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/wait.h>
 
+#include "checksum.hpp"
+#include "hdr_histogram.hpp"
+#include "shm_ring.hpp"
+#include "uring.hpp"
+
 #define TOTAL_BYTES (10ULL * 1024 * 1024 * 1024)
 #define BUFFER_SIZE (64 * 1024)
+#define PAGE_BYTES 4096
 
-int main() {
+// Standard benchmark: write() -> pipe -> read(), matches the C and Rust versions
+static int run_standard() {
     int pipe_fds[2];
     if (pipe(pipe_fds) == -1) return 1;
 
@@ -43,7 +65,7 @@ int main() {
 
         auto end = std::chrono::high_resolution_clock::now();
         double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
-        std::printf("elapsed_ms=%.3f throughput_gb_sec=%.3f\n", 
+        std::printf("elapsed_ms=%.3f throughput_gb_sec=%.3f\n",
                     elapsed_ms, (TOTAL_BYTES / 1024.0 / 1024.0 / 1024.0) / (elapsed_ms / 1000.0));
 
         close(pipe_fds[1]);
@@ -51,3 +73,1139 @@ int main() {
     }
     return 0;
 }
+
+// ---------------------------------------------------------------------------
+// Transfer harness for the extended modes
+//
+// Every mode moves a stream of `total` bytes (TOTAL_BYTES unless the sweep
+// asks for less): chunks of `chunk` bytes, each filled with the standard
+// (uint8_t)i pattern. The reader runs in a forked child and hands its byte
+// count and XOR checksum back through a shared anonymous mapping, so the
+// parent prints one line per mode.
+
+struct ReaderResult {
+    uint64_t bytes;
+    uint32_t checksum;     // XOR byte, or CRC-32C in verify mode
+    bool checked;          // False when the reader never sees the data (splice sink)
+    double verify_ms = -1;  // Reader time spent verifying, when measured
+};
+
+static void fill_pattern(uint8_t* buf, size_t len) {
+    for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)i;
+}
+
+static uint8_t expected_checksum(size_t chunk, uint64_t total) {
+    // Full chunks cancel in pairs; an odd one and the tail contribute once
+    uint8_t chunk_xor = 0;
+    for (size_t i = 0; i < chunk; i++) chunk_xor ^= (uint8_t)i;
+    uint64_t full = total / chunk;
+    uint8_t sum = (full & 1) ? chunk_xor : 0;
+    for (size_t i = 0; i < total % chunk; i++) sum ^= (uint8_t)i;
+    return sum;
+}
+
+static uint8_t* alloc_pages(size_t bytes) {
+    void* p = nullptr;
+    if (posix_memalign(&p, PAGE_BYTES, bytes) != 0) {
+        perror("posix_memalign");
+        exit(1);
+    }
+    return static_cast<uint8_t*>(p);
+}
+
+// Wall time of the writer, CPU time (user + system) of each side
+struct TransferStats {
+    double elapsed_ms;
+    double writer_cpu_ms;
+    double reader_cpu_ms;
+};
+
+static double cpu_time_ms(int who) {
+    rusage usage;
+    getrusage(who, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+// capacity: the pipe size after F_SETPIPE_SZ, or the shared ring size
+// expected/digits: the reference checksum and its width in hex digits
+static bool report(const char* mode, size_t chunk, uint64_t total, size_t capacity, const TransferStats& t,
+                   const ReaderResult& r, uint32_t expected, int digits = 2) {
+    bool ok = r.bytes == total && (!r.checked || r.checksum == expected);
+    std::printf("mode=%s chunk=%zu capacity=%zu elapsed_ms=%.3f throughput_gb_sec=%.3f writer_cpu_ms=%.1f "
+                "reader_cpu_ms=%.1f ",
+                mode, chunk, capacity, t.elapsed_ms, (total / 1024.0 / 1024.0 / 1024.0) / (t.elapsed_ms / 1000.0),
+                t.writer_cpu_ms, t.reader_cpu_ms);
+    if (r.verify_ms >= 0) {
+        std::printf("verify_ms=%.1f ", r.verify_ms);
+    }
+    if (r.checked) {
+        std::printf("checksum=%0*x ", digits, r.checksum);
+    } else {
+        std::printf("checksum=n/a ");
+    }
+    std::printf("expected=%0*x bytes=%llu status=%s\n", digits, expected, (unsigned long long)r.bytes,
+                ok ? "OK" : "MISMATCH");
+    std::fflush(stdout);
+    return ok;
+}
+
+// The child's path ends in _exit(), which GCC treats as cold and compiles
+// for size, scalarising the reader's checksum loop. Keep the reader out of
+// line and marked hot so it is optimised like the writer.
+template <typename Reader>
+__attribute__((noinline, hot)) static ReaderResult run_reader(Reader& reader) {
+    return reader();
+}
+
+// Runs reader() in a forked child and writer() in the parent. Elapsed time
+// is the writer's, as in the standard benchmark. The reader's CPU time
+// comes from RUSAGE_CHILDREN once it has been reaped.
+template <typename Reader, typename Writer>
+static TransferStats run_forked(Reader reader, Writer writer, ReaderResult& result) {
+    void* mem = mmap(nullptr, sizeof(ReaderResult), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        perror("mmap");
+        exit(1);
+    }
+    auto* shared = static_cast<ReaderResult*>(mem);
+    *shared = ReaderResult{0, 0, false};
+    double children_cpu = cpu_time_ms(RUSAGE_CHILDREN);
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("fork");
+        exit(1);
+    }
+    if (pid == 0) {
+        *shared = run_reader(reader);
+        _exit(0);
+    }
+
+    double self_cpu = cpu_time_ms(RUSAGE_SELF);
+    auto start = std::chrono::steady_clock::now();
+    writer();
+    auto end = std::chrono::steady_clock::now();
+    TransferStats stats;
+    stats.writer_cpu_ms = cpu_time_ms(RUSAGE_SELF) - self_cpu;
+    waitpid(pid, nullptr, 0);
+    stats.reader_cpu_ms = cpu_time_ms(RUSAGE_CHILDREN) - children_cpu;
+    stats.elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    result = *shared;
+    munmap(mem, sizeof(ReaderResult));
+    return stats;
+}
+
+// Writers: return bytes sent
+
+static uint64_t write_all(int fd, size_t chunk, uint64_t total) {
+    std::vector<uint8_t> buffer(chunk);
+    fill_pattern(buffer.data(), chunk);
+    uint64_t sent = 0;
+    while (sent < total) {
+        size_t len = (size_t)std::min<uint64_t>(chunk, total - sent);
+        ssize_t n = write(fd, buffer.data(), len);
+        if (n <= 0) break;
+        sent += n;
+    }
+    return sent;
+}
+
+// vmsplice() does not copy: the pipe holds references to the writer's pages
+// until the reader consumes them, so a buffer must not be rewritten while
+// any of its pages may still sit in the pipe. The pipe holds at most
+// pipe_bytes, so once pipe_bytes of newer data have been queued behind a
+// buffer, all of it has been read out. The writer therefore rotates through
+// pipe_bytes / chunk + 1 page-aligned buffers, and a buffer comes round
+// again only after that point; a producer that regenerates data in place
+// could do so safely at that moment.
+//
+// SPLICE_F_GIFT is not used: gifted pages must never be touched again, which
+// would mean fresh pages (and page faults) for every chunk.
+static uint64_t vmsplice_all(int fd, size_t chunk, uint64_t total, size_t pipe_bytes) {
+    size_t slots = pipe_bytes / chunk + 1 + (pipe_bytes % chunk != 0);
+    uint8_t* ring = alloc_pages(slots * chunk);
+    for (size_t s = 0; s < slots; s++) fill_pattern(ring + s * chunk, chunk);
+
+    uint64_t sent = 0;
+    size_t slot = 0;
+    while (sent < total) {
+        size_t len = (size_t)std::min<uint64_t>(chunk, total - sent);
+        struct iovec iov = {ring + slot * chunk, len};
+        while (iov.iov_len > 0) {
+            ssize_t n = vmsplice(fd, &iov, 1, 0);
+            if (n <= 0) {
+                free(ring);
+                return sent;
+            }
+            iov.iov_base = static_cast<uint8_t*>(iov.iov_base) + n;
+            iov.iov_len -= n;
+            sent += n;
+        }
+        slot = (slot + 1) % slots;
+    }
+    free(ring);
+    return sent;
+}
+
+// Readers
+
+static ReaderResult read_all(int fd, size_t chunk, uint64_t total) {
+    std::vector<uint8_t> buffer(chunk);
+    ReaderResult r{0, 0, true};
+    uint8_t checksum = 0;
+    while (r.bytes < total) {
+        ssize_t n = read(fd, buffer.data(), chunk);
+        if (n <= 0) break;
+        for (ssize_t i = 0; i < n; i++) checksum ^= buffer[i];
+        r.bytes += n;
+    }
+    r.checksum = checksum;
+    return r;
+}
+
+// splice() from the pipe into /dev/null: the pages are released without
+// ever being mapped into the reader, so only the byte count is verified
+static ReaderResult splice_sink_all(int fd, size_t chunk, uint64_t total) {
+    ReaderResult r{0, 0, false};
+    int sink = open("/dev/null", O_WRONLY);
+    if (sink == -1) {
+        perror("open /dev/null");
+        return r;
+    }
+    while (r.bytes < total) {
+        ssize_t n = splice(fd, nullptr, sink, nullptr, chunk, SPLICE_F_MOVE);
+        if (n <= 0) break;
+        r.bytes += n;
+    }
+    close(sink);
+    return r;
+}
+
+// io_uring writer/reader: `depth` requests per io_uring_enter, each on its
+// own registered fixed buffer, submitted and reaped as one batch.
+//
+// Several requests in flight on one pipe may run in any order, so a batch
+// is one chain. Writes use IOSQE_IO_LINK: a short write breaks the chain,
+// the kernel cancels the rest, and the next batch restarts right after the
+// last byte written, which keeps the stream in order. Reads use
+// IOSQE_IO_HARDLINK, since a short read is normal on a pipe and must not
+// cancel the reads queued behind it.
+
+static bool uring_setup(Uring& ring, std::vector<uint8_t*>& bufs, size_t chunk, unsigned depth) {
+    if (!ring.init(depth)) {
+        perror("io_uring_setup");
+        return false;
+    }
+    std::vector<iovec> iovs(depth);
+    for (unsigned i = 0; i < depth; i++) {
+        bufs.push_back(alloc_pages(chunk));
+        fill_pattern(bufs[i], chunk);
+        iovs[i] = {bufs[i], chunk};
+    }
+    if (!ring.register_buffers(iovs.data(), depth)) {
+        perror("io_uring_register");
+        return false;
+    }
+    return true;
+}
+
+// Reaps `count` completions into res[user_data]
+static void uring_reap(Uring& ring, std::vector<int>& res, unsigned count) {
+    for (unsigned done = 0; done < count;) {
+        io_uring_cqe* cqe = ring.peek_cqe();
+        if (!cqe) {
+            ring.submit_and_wait(count - done);
+            continue;
+        }
+        res[cqe->user_data] = cqe->res;
+        ring.cqe_seen();
+        done++;
+    }
+}
+
+static uint64_t uring_write_all(int fd, size_t chunk, uint64_t total, unsigned depth) {
+    Uring ring;
+    std::vector<uint8_t*> bufs;
+    std::vector<int> res(depth);
+    std::vector<size_t> lens(depth);
+    uint64_t sent = 0;
+
+    if (uring_setup(ring, bufs, chunk, depth)) {
+        while (sent < total) {
+            unsigned n = 0;
+            io_uring_sqe* last = nullptr;
+            for (uint64_t pos = sent; n < depth && pos < total; n++) {
+                // Every buffer holds the same chunk, so a stream position
+                // maps to the same offset in any of them
+                size_t off = pos % chunk;
+                lens[n] = (size_t)std::min<uint64_t>(chunk - off, total - pos);
+                last = ring.get_sqe();
+                ring.prep_rw(last, IORING_OP_WRITE_FIXED, fd, bufs[n] + off, (unsigned)lens[n], n, n);
+                last->flags = IOSQE_IO_LINK;
+                pos += lens[n];
+            }
+            last->flags = 0;
+            if (ring.submit_and_wait(n) < 0) break;
+            uring_reap(ring, res, n);
+
+            bool failed = false;
+            for (unsigned k = 0; k < n; k++) {
+                if (res[k] < 0) {
+                    failed = res[k] != -ECANCELED;
+                    break;
+                }
+                sent += res[k];
+                if ((size_t)res[k] < lens[k]) break;  // Short: the rest was cancelled
+            }
+            if (failed) break;
+        }
+    }
+    for (uint8_t* b : bufs) free(b);
+    return sent;
+}
+
+static ReaderResult uring_read_all(int fd, size_t chunk, uint64_t total, unsigned depth) {
+    Uring ring;
+    std::vector<uint8_t*> bufs;
+    std::vector<int> res(depth);
+    ReaderResult r{0, 0, true};
+    uint8_t checksum = 0;
+
+    if (uring_setup(ring, bufs, chunk, depth)) {
+        bool eof = false;
+        while (!eof && r.bytes < total) {
+            io_uring_sqe* last = nullptr;
+            for (unsigned k = 0; k < depth; k++) {
+                last = ring.get_sqe();
+                ring.prep_rw(last, IORING_OP_READ_FIXED, fd, bufs[k], (unsigned)chunk, k, k);
+                last->flags = IOSQE_IO_HARDLINK;
+            }
+            last->flags = 0;
+            if (ring.submit_and_wait(depth) < 0) break;
+            uring_reap(ring, res, depth);
+
+            for (unsigned k = 0; k < depth && !eof; k++) {
+                if (res[k] <= 0) {
+                    eof = true;
+                    break;
+                }
+                for (int i = 0; i < res[k]; i++) checksum ^= bufs[k][i];
+                r.bytes += res[k];
+            }
+        }
+    }
+    for (uint8_t* b : bufs) free(b);
+    r.checksum = checksum;
+    return r;
+}
+
+// ---------------------------------------------------------------------------
+// Pipe transfers: writer kind x reader kind over one pipe
+
+enum class WriterKind { Write, Vmsplice, Uring };
+enum class ReaderKind { Read, SpliceSink, Uring };
+
+struct PipeTransfer {
+    WriterKind writer;
+    ReaderKind reader;
+    size_t chunk;
+    size_t pipe_size;  // F_SETPIPE_SZ request; 0 keeps the default
+    unsigned depth;    // io_uring queue depth
+    uint64_t total = TOTAL_BYTES;
+};
+
+static size_t pipe_max_size() {
+    size_t max = 1 << 20;
+    FILE* f = std::fopen("/proc/sys/fs/pipe-max-size", "r");
+    if (f) {
+        if (std::fscanf(f, "%zu", &max) != 1) max = 1 << 20;
+        std::fclose(f);
+    }
+    return max;
+}
+
+static bool run_pipe_transfer(const char* mode, const PipeTransfer& t, TransferStats* out = nullptr) {
+    int fds[2];
+    if (pipe(fds) == -1) {
+        perror("pipe");
+        return false;
+    }
+    if (t.pipe_size && fcntl(fds[1], F_SETPIPE_SZ, (int)t.pipe_size) == -1) {
+        perror("F_SETPIPE_SZ");
+    }
+    size_t pipe_bytes = (size_t)fcntl(fds[1], F_GETPIPE_SZ);
+
+    ReaderResult result;
+    TransferStats stats = run_forked(
+        [&] {
+            close(fds[1]);
+            ReaderResult r;
+            switch (t.reader) {
+            case ReaderKind::Read: r = read_all(fds[0], t.chunk, t.total); break;
+            case ReaderKind::SpliceSink: r = splice_sink_all(fds[0], t.chunk, t.total); break;
+            case ReaderKind::Uring: r = uring_read_all(fds[0], t.chunk, t.total, t.depth); break;
+            }
+            close(fds[0]);
+            return r;
+        },
+        [&] {
+            close(fds[0]);
+            switch (t.writer) {
+            case WriterKind::Write: write_all(fds[1], t.chunk, t.total); break;
+            case WriterKind::Vmsplice: vmsplice_all(fds[1], t.chunk, t.total, pipe_bytes); break;
+            case WriterKind::Uring: uring_write_all(fds[1], t.chunk, t.total, t.depth); break;
+            }
+            close(fds[1]);
+        },
+        result);
+    if (out) *out = stats;
+    return report(mode, t.chunk, t.total, pipe_bytes, stats, result, expected_checksum(t.chunk, t.total));
+}
+
+// Shared-memory ring: the writer builds each chunk in place with reserve()
+// (one memcpy from its source buffer, standing in for producing the data)
+// and the reader checksums it in place with peek(). One copy in total
+// versus two through a pipe, and no syscall unless a side has to sleep.
+static bool run_shm_transfer(const char* mode, size_t chunk, size_t capacity, uint64_t total = TOTAL_BYTES) {
+    ShmRing ring;
+    if (!ring.create(capacity)) return false;
+
+    ReaderResult result;
+    TransferStats stats = run_forked(
+        [&] {
+            ReaderResult r{0, 0, true};
+            uint8_t checksum = 0;
+            for (;;) {
+                size_t len;
+                const uint8_t* p = ring.peek(chunk, len);
+                if (len == 0) break;
+                for (size_t i = 0; i < len; i++) checksum ^= p[i];
+                ring.release(len);
+                r.bytes += len;
+            }
+            r.checksum = checksum;
+            return r;
+        },
+        [&] {
+            std::vector<uint8_t> buffer(chunk);
+            fill_pattern(buffer.data(), chunk);
+            for (uint64_t sent = 0; sent < total;) {
+                size_t len = (size_t)std::min<uint64_t>(chunk, total - sent);
+                std::memcpy(ring.reserve(len), buffer.data(), len);
+                ring.commit(len);
+                sent += len;
+            }
+            ring.close();
+        },
+        result);
+    return report(mode, chunk, total, capacity, stats, result, expected_checksum(chunk, total));
+}
+
+// Splice mode: write/vmsplice writers x read/splice-sink readers
+static int run_splice_comparison() {
+    std::printf("=== Zero-copy: %llu bytes, %d byte chunks, default pipe size ===\n", TOTAL_BYTES, BUFFER_SIZE);
+    bool ok = true;
+    ok &= run_pipe_transfer("write_read", {WriterKind::Write, ReaderKind::Read, BUFFER_SIZE, 0, 0});
+    ok &= run_pipe_transfer("vmsplice_read", {WriterKind::Vmsplice, ReaderKind::Read, BUFFER_SIZE, 0, 0});
+    ok &= run_pipe_transfer("write_splice_sink", {WriterKind::Write, ReaderKind::SpliceSink, BUFFER_SIZE, 0, 0});
+    ok &= run_pipe_transfer("vmsplice_splice_sink", {WriterKind::Vmsplice, ReaderKind::SpliceSink, BUFFER_SIZE, 0, 0});
+    return ok ? 0 : 1;
+}
+
+// io_uring mode: blocking read/write vs batched io_uring on both ends, per
+// buffer size. The pipe is sized to hold one full batch (capped at
+// pipe-max-size), and both rows of a buffer size use the same pipe.
+static constexpr size_t URING_CHUNKS[] = {4096, 16384, 65536, 262144, 1048576};
+static constexpr unsigned URING_QUEUE_DEPTH = 8;
+
+static int run_uring_comparison(unsigned depth) {
+    std::printf("=== io_uring: %llu bytes, queue depth %u, fixed buffers ===\n", TOTAL_BYTES, depth);
+    bool ok = true;
+    for (size_t chunk : URING_CHUNKS) {
+        size_t pipe_size = std::min(chunk * depth, pipe_max_size());
+        ok &= run_pipe_transfer("write_read", {WriterKind::Write, ReaderKind::Read, chunk, pipe_size, depth});
+        ok &= run_pipe_transfer("uring", {WriterKind::Uring, ReaderKind::Uring, chunk, pipe_size, depth});
+    }
+    return ok ? 0 : 1;
+}
+
+// Shm mode: pipe (default and ring-sized) vs the shared-memory ring
+static constexpr size_t SHM_RING_BYTES = 1 << 20;
+
+static int run_shm_comparison() {
+    std::printf("=== Shared memory: %llu bytes, %d byte chunks, %zu byte ring ===\n", TOTAL_BYTES, BUFFER_SIZE,
+                SHM_RING_BYTES);
+    bool ok = true;
+    ok &= run_pipe_transfer("pipe_default", {WriterKind::Write, ReaderKind::Read, BUFFER_SIZE, 0, 0});
+    ok &= run_pipe_transfer("pipe_1m", {WriterKind::Write, ReaderKind::Read, BUFFER_SIZE, SHM_RING_BYTES, 0});
+    ok &= run_shm_transfer("shm_ring", BUFFER_SIZE, SHM_RING_BYTES);
+    return ok ? 0 : 1;
+}
+
+// ---------------------------------------------------------------------------
+// Other IPC transports under the same harness: AF_UNIX socket pairs and a
+// shared buffer signalled through eventfds
+
+// socketpair(AF_UNIX, type): the plain write_all/read_all ends work on any
+// fd. SOCK_SEQPACKET keeps message boundaries, so each write() is one
+// record (a chunk must fit SO_SNDBUF) and each read() returns one record.
+static bool run_socket_transfer(const char* mode, int type, size_t chunk, uint64_t total = TOTAL_BYTES) {
+    int fds[2];
+    if (socketpair(AF_UNIX, type, 0, fds) == -1) {
+        perror("socketpair");
+        return false;
+    }
+    int sndbuf = 0;
+    socklen_t optlen = sizeof(sndbuf);
+    getsockopt(fds[1], SOL_SOCKET, SO_SNDBUF, &sndbuf, &optlen);
+
+    ReaderResult result;
+    TransferStats stats = run_forked(
+        [&] {
+            close(fds[1]);
+            ReaderResult r = read_all(fds[0], chunk, total);
+            close(fds[0]);
+            return r;
+        },
+        [&] {
+            close(fds[0]);
+            write_all(fds[1], chunk, total);
+            close(fds[1]);
+        },
+        result);
+    return report(mode, chunk, total, (size_t)sndbuf, stats, result, expected_checksum(chunk, total));
+}
+
+// MSG_ZEROCOPY needs SO_ZEROCOPY on the socket, which Linux only accepts
+// for TCP, UDP and RDS; an AF_UNIX send ignores the flag and copies. Probe
+// it rather than report a copying run under a zero-copy name.
+static bool socket_zerocopy_supported(int type, int& err) {
+    int fds[2];
+    if (socketpair(AF_UNIX, type, 0, fds) == -1) {
+        err = errno;
+        return false;
+    }
+    int one = 1;
+    bool ok = setsockopt(fds[1], SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+    err = errno;
+    close(fds[0]);
+    close(fds[1]);
+    return ok;
+}
+
+// Eventfd-signalled shared buffer: chunk-sized slots in a MAP_SHARED
+// mapping and two eventfd counters. The writer copies a chunk into the next
+// free slot and adds 1 to `filled`. The reader's read() of `filled` returns
+// and resets the number of ready slots; it checksums them in place and
+// hands them back by adding the same number to `freed`. Same single copy as
+// ShmRing, but every chunk costs an eventfd write and a waiting side always
+// sleeps in read() instead of spinning first.
+static bool run_eventfd_transfer(const char* mode, size_t chunk, size_t capacity, uint64_t total = TOTAL_BYTES) {
+    size_t slots = std::max<size_t>(1, capacity / chunk);
+    void* mem = mmap(nullptr, slots * chunk, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+    auto* data = static_cast<uint8_t*>(mem);
+    int filled = eventfd(0, 0);
+    int freed = eventfd(0, 0);
+    if (filled == -1 || freed == -1) {
+        perror("eventfd");
+        return false;
+    }
+
+    ReaderResult result;
+    TransferStats stats = run_forked(
+        [&] {
+            ReaderResult r{0, 0, true};
+            uint8_t checksum = 0;
+            size_t slot = 0;
+            while (r.bytes < total) {
+                uint64_t ready;
+                if (read(filled, &ready, sizeof(ready)) != sizeof(ready)) break;
+                for (uint64_t k = 0; k < ready; k++) {
+                    size_t len = (size_t)std::min<uint64_t>(chunk, total - r.bytes);
+                    const uint8_t* p = data + slot * chunk;
+                    for (size_t i = 0; i < len; i++) checksum ^= p[i];
+                    r.bytes += len;
+                    slot = (slot + 1) % slots;
+                }
+                if (write(freed, &ready, sizeof(ready)) != sizeof(ready)) break;
+            }
+            r.checksum = checksum;
+            return r;
+        },
+        [&] {
+            std::vector<uint8_t> buffer(chunk);
+            fill_pattern(buffer.data(), chunk);
+            uint64_t credits = slots;
+            size_t slot = 0;
+            for (uint64_t sent = 0; sent < total;) {
+                if (credits == 0 && read(freed, &credits, sizeof(credits)) != sizeof(credits)) break;
+                size_t len = (size_t)std::min<uint64_t>(chunk, total - sent);
+                std::memcpy(data + slot * chunk, buffer.data(), len);
+                uint64_t one = 1;
+                if (write(filled, &one, sizeof(one)) != sizeof(one)) break;
+                credits--;
+                sent += len;
+                slot = (slot + 1) % slots;
+            }
+        },
+        result);
+    close(filled);
+    close(freed);
+    munmap(mem, slots * chunk);
+    return report(mode, chunk, total, slots * chunk, stats, result, expected_checksum(chunk, total));
+}
+
+// IPC mode: pipe vs AF_UNIX sockets vs the two shared-memory transports
+static int run_ipc_comparison() {
+    std::printf("=== IPC transports: %llu bytes, %d byte chunks ===\n", TOTAL_BYTES, BUFFER_SIZE);
+    bool ok = true;
+    ok &= run_pipe_transfer("pipe_default", {WriterKind::Write, ReaderKind::Read, BUFFER_SIZE, 0, 0});
+    ok &= run_pipe_transfer("pipe_1m", {WriterKind::Write, ReaderKind::Read, BUFFER_SIZE, SHM_RING_BYTES, 0});
+    ok &= run_socket_transfer("unix_stream", SOCK_STREAM, BUFFER_SIZE);
+    ok &= run_socket_transfer("unix_seqpacket", SOCK_SEQPACKET, BUFFER_SIZE);
+    int err = 0;
+    if (socket_zerocopy_supported(SOCK_STREAM, err)) {
+        std::printf("note: SO_ZEROCOPY accepted on AF_UNIX; this build has no MSG_ZEROCOPY writer for it\n");
+    } else {
+        std::printf("skip mode=unix_stream_zerocopy reason=SO_ZEROCOPY: %s\n", std::strerror(err));
+    }
+    ok &= run_eventfd_transfer("eventfd_shm", BUFFER_SIZE, SHM_RING_BYTES);
+    ok &= run_shm_transfer("shm_ring", BUFFER_SIZE, SHM_RING_BYTES);
+    return ok ? 0 : 1;
+}
+
+// Verify mode: the reader checks the stream with the byte XOR loop, the
+// vectorised XOR or CRC-32C. Each chunk carries its stream offset in its
+// first 8 bytes, so reordered or duplicated chunks change the CRC (the
+// plain pattern repeats every chunk and would hide them). Reference
+// values are computed once, off the clock, from the same stream.
+enum class Verify { XorBytes, XorWide, Crc32c };
+
+struct StreamDigest {
+    uint8_t xor_sum;
+    uint32_t crc;
+};
+
+static void stamp_chunk(uint8_t* buf, uint64_t offset) {
+    std::memcpy(buf, &offset, sizeof(offset));
+}
+
+static StreamDigest digest_stamped_stream(size_t chunk, uint64_t total, const Crc32c& crc) {
+    std::vector<uint8_t> buffer(chunk);
+    fill_pattern(buffer.data(), chunk);
+    StreamDigest d{0, 0};
+    for (uint64_t pos = 0; pos < total; pos += chunk) {
+        size_t len = (size_t)std::min<uint64_t>(chunk, total - pos);
+        stamp_chunk(buffer.data(), pos);
+        d.xor_sum = xor_wide(d.xor_sum, buffer.data(), len);
+        d.crc = crc.update(d.crc, buffer.data(), len);
+    }
+    return d;
+}
+
+static bool run_verify_transfer(const char* mode, Verify verify, size_t chunk, uint64_t total, const Crc32c& crc,
+                                const StreamDigest& expected) {
+    int fds[2];
+    if (pipe(fds) == -1) {
+        perror("pipe");
+        return false;
+    }
+    size_t pipe_bytes = (size_t)fcntl(fds[1], F_GETPIPE_SZ);
+
+    ReaderResult result;
+    TransferStats stats = run_forked(
+        [&] {
+            close(fds[1]);
+            std::vector<uint8_t> buffer(chunk);
+            ReaderResult r{0, 0, true};
+            uint8_t xor_sum = 0;
+            uint32_t crc_sum = 0;
+            std::chrono::steady_clock::duration busy{};
+            while (r.bytes < total) {
+                ssize_t n = read(fds[0], buffer.data(), chunk);
+                if (n <= 0) break;
+                auto start = std::chrono::steady_clock::now();
+                switch (verify) {
+                case Verify::XorBytes:
+                    for (ssize_t i = 0; i < n; i++) xor_sum ^= buffer[i];
+                    break;
+                case Verify::XorWide: xor_sum = xor_wide(xor_sum, buffer.data(), n); break;
+                case Verify::Crc32c: crc_sum = crc.update(crc_sum, buffer.data(), n); break;
+                }
+                busy += std::chrono::steady_clock::now() - start;
+                r.bytes += n;
+            }
+            close(fds[0]);
+            r.checksum = verify == Verify::Crc32c ? crc_sum : xor_sum;
+            r.verify_ms = std::chrono::duration<double, std::milli>(busy).count();
+            return r;
+        },
+        [&] {
+            close(fds[0]);
+            std::vector<uint8_t> buffer(chunk);
+            fill_pattern(buffer.data(), chunk);
+            for (uint64_t sent = 0; sent < total;) {
+                // The whole chunk is written before it is stamped again
+                stamp_chunk(buffer.data(), sent);
+                size_t len = (size_t)std::min<uint64_t>(chunk, total - sent);
+                size_t done = 0;
+                while (done < len) {
+                    ssize_t n = write(fds[1], buffer.data() + done, len - done);
+                    if (n <= 0) break;
+                    done += n;
+                }
+                if (done < len) break;
+                sent += len;
+            }
+            close(fds[1]);
+        },
+        result);
+    if (verify == Verify::Crc32c) {
+        return report(mode, chunk, total, pipe_bytes, stats, result, expected.crc, 8);
+    }
+    return report(mode, chunk, total, pipe_bytes, stats, result, expected.xor_sum);
+}
+
+static int run_verify_comparison() {
+    Crc32c crc;
+    StreamDigest expected = digest_stamped_stream(BUFFER_SIZE, TOTAL_BYTES, crc);
+    std::printf("=== Verify: %llu bytes, %d byte chunks, crc32c=%s ===\n", TOTAL_BYTES, BUFFER_SIZE,
+                crc.hardware() ? "hardware" : "software");
+    bool ok = true;
+    ok &= run_verify_transfer("xor_bytes", Verify::XorBytes, BUFFER_SIZE, TOTAL_BYTES, crc, expected);
+    ok &= run_verify_transfer("xor_wide", Verify::XorWide, BUFFER_SIZE, TOTAL_BYTES, crc, expected);
+    ok &= run_verify_transfer("crc32c", Verify::Crc32c, BUFFER_SIZE, TOTAL_BYTES, crc, expected);
+    return ok ? 0 : 1;
+}
+
+// Multi mode: N pipes, one writer thread per pipe in the parent, and in the
+// reader process either one blocking thread per pipe or a few epoll
+// reactors. TOTAL_BYTES is split evenly over the streams. Each stream
+// records when its last byte arrived; per-stream GB/s over that time gives
+// the fairness figures (Jain's index: 1.0 when all streams are equal).
+enum class MultiReader { ThreadPerPipe, Epoll };
+
+struct StreamResult {
+    uint64_t bytes;
+    uint8_t checksum;
+    int64_t finish_ns;
+};
+
+static int64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Edge-triggered: every readiness event is drained until EAGAIN, since
+// the next event only comes with new data
+static void epoll_reactor(const std::vector<int>& fds, const std::vector<int>& owned, StreamResult* streams,
+                          size_t chunk) {
+    int ep = epoll_create1(0);
+    if (ep == -1) {
+        perror("epoll_create1");
+        return;
+    }
+    for (int i : owned) {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.u32 = (uint32_t)i;
+        epoll_ctl(ep, EPOLL_CTL_ADD, fds[i], &ev);
+    }
+    std::vector<uint8_t> buffer(chunk);
+    std::vector<epoll_event> events(owned.size());
+    size_t open = owned.size();
+    while (open > 0) {
+        int n = epoll_wait(ep, events.data(), (int)events.size(), -1);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) break;
+        for (int e = 0; e < n; e++) {
+            int i = (int)events[e].data.u32;
+            StreamResult& st = streams[i];
+            uint8_t checksum = st.checksum;
+            for (;;) {
+                ssize_t got = read(fds[i], buffer.data(), chunk);
+                if (got > 0) {
+                    for (ssize_t k = 0; k < got; k++) checksum ^= buffer[k];
+                    st.bytes += got;
+                    continue;
+                }
+                if (got < 0 && errno == EAGAIN) break;
+                // EOF or error: the stream is done
+                st.finish_ns = monotonic_ns();
+                epoll_ctl(ep, EPOLL_CTL_DEL, fds[i], nullptr);
+                open--;
+                break;
+            }
+            st.checksum = checksum;
+        }
+    }
+    close(ep);
+}
+
+static bool run_multi_stream(const char* mode, int count, MultiReader kind, int reactors, size_t chunk) {
+    uint64_t per_stream = TOTAL_BYTES / count;
+    std::vector<int> rfds(count), wfds(count);
+    for (int i = 0; i < count; i++) {
+        int fds[2];
+        if (pipe(fds) == -1) {
+            perror("pipe");
+            return false;
+        }
+        rfds[i] = fds[0];
+        wfds[i] = fds[1];
+        if (kind == MultiReader::Epoll) fcntl(rfds[i], F_SETFL, O_NONBLOCK);
+    }
+    size_t pipe_bytes = (size_t)fcntl(wfds[0], F_GETPIPE_SZ);
+    size_t shared_bytes = sizeof(StreamResult) * count;
+    void* mem = mmap(nullptr, shared_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+    auto* streams = static_cast<StreamResult*>(mem);
+    for (int i = 0; i < count; i++) streams[i] = StreamResult{0, 0, 0};
+
+    int64_t start_ns = 0;
+    ReaderResult result;
+    TransferStats stats = run_forked(
+        [&] {
+            for (int fd : wfds) close(fd);
+            std::vector<std::thread> threads;
+            if (kind == MultiReader::ThreadPerPipe) {
+                for (int i = 0; i < count; i++) {
+                    threads.emplace_back([&, i] {
+                        ReaderResult r = read_all(rfds[i], chunk, per_stream);
+                        streams[i] = StreamResult{r.bytes, (uint8_t)r.checksum, monotonic_ns()};
+                    });
+                }
+            } else {
+                for (int t = 0; t < reactors; t++) {
+                    std::vector<int> owned;
+                    for (int i = t; i < count; i += reactors) owned.push_back(i);
+                    threads.emplace_back(epoll_reactor, std::cref(rfds), owned, streams, chunk);
+                }
+            }
+            for (auto& t : threads) t.join();
+            for (int fd : rfds) close(fd);
+
+            ReaderResult r{0, 0, true};
+            for (int i = 0; i < count; i++) {
+                r.bytes += streams[i].bytes;
+                r.checksum ^= streams[i].checksum;
+            }
+            return r;
+        },
+        [&] {
+            for (int fd : rfds) close(fd);
+            start_ns = monotonic_ns();
+            std::vector<std::thread> writers;
+            for (int i = 0; i < count; i++) {
+                writers.emplace_back([&, i] {
+                    write_all(wfds[i], chunk, per_stream);
+                    close(wfds[i]);
+                });
+            }
+            for (auto& t : writers) t.join();
+        },
+        result);
+
+    // Per-stream throughput from the writers' start to the stream's last byte
+    double sum = 0, sum_sq = 0, min_gbps = 1e30, max_gbps = 0;
+    int streams_ok = 0;
+    uint8_t expected = expected_checksum(chunk, per_stream);
+    for (int i = 0; i < count; i++) {
+        double secs = (streams[i].finish_ns - start_ns) / 1e9;
+        double gbps = secs > 0 ? (streams[i].bytes / 1024.0 / 1024.0 / 1024.0) / secs : 0.0;
+        sum += gbps;
+        sum_sq += gbps * gbps;
+        min_gbps = std::min(min_gbps, gbps);
+        max_gbps = std::max(max_gbps, gbps);
+        streams_ok += streams[i].bytes == per_stream && streams[i].checksum == expected;
+    }
+    munmap(mem, shared_bytes);
+
+    // All streams carry identical data, so the aggregate XOR is the
+    // per-stream value folded `count` times
+    bool ok = report(mode, chunk, per_stream * count, pipe_bytes, stats, result, (count & 1) ? expected : 0);
+    std::printf("  streams=%d reactors=%d jain_fairness=%.4f min_stream_gb_sec=%.3f max_stream_gb_sec=%.3f "
+                "streams_ok=%d\n",
+                count, kind == MultiReader::Epoll ? reactors : 0, sum * sum / (count * sum_sq), min_gbps, max_gbps,
+                streams_ok);
+    std::fflush(stdout);
+    return ok && streams_ok == count;
+}
+
+static int run_multi_comparison(int max_streams) {
+    int reactors = std::max(1, (int)std::thread::hardware_concurrency() / 4);
+    std::printf("=== Multi-stream: %llu bytes split over N pipes, %d byte chunks, %d epoll reactor(s) ===\n",
+                TOTAL_BYTES, BUFFER_SIZE, reactors);
+    bool ok = true;
+    std::vector<int> counts;
+    for (int n = 1; n < max_streams; n *= 2) counts.push_back(n);
+    counts.push_back(max_streams);
+    for (int n : counts) {
+        ok &= run_multi_stream("thread_per_pipe", n, MultiReader::ThreadPerPipe, 0, BUFFER_SIZE);
+        ok &= run_multi_stream("epoll_et", n, MultiReader::Epoll, std::min(reactors, n), BUFFER_SIZE);
+    }
+    return ok ? 0 : 1;
+}
+
+// Ping-pong mode: round-trip latency over two pipes. The parent writes a
+// message into one pipe, the child echoes it back through the other, and
+// the parent records each round trip in an HdrHistogram. Options:
+//   busy: both sides poll non-blocking pipes instead of sleeping in read()
+//   pin:  parent and child are pinned to two different allowed CPUs
+static constexpr size_t PINGPONG_SIZES[] = {8, 64, 512, 4096};
+static constexpr int PINGPONG_ROUNDS = 200000;
+static constexpr int PINGPONG_WARMUP = 10000;
+static constexpr int BUSY_POLL_YIELD = 64;  // Spins between sched_yield() calls on a shared CPU
+
+// Reads exactly len bytes. Busy mode spins on EAGAIN; yield_spins > 0 adds
+// a sched_yield() every yield_spins spins, so two pollers forced onto one
+// CPU still make progress.
+static bool read_exact(int fd, uint8_t* buf, size_t len, bool busy, int yield_spins = 0) {
+    size_t done = 0;
+    int spins = 0;
+    while (done < len) {
+        ssize_t n = read(fd, buf + done, len - done);
+        if (n > 0) {
+            done += n;
+        } else if (n < 0 && errno == EAGAIN && busy) {
+            SPIN_PAUSE();
+            if (++spins == yield_spins) {
+                spins = 0;
+                sched_yield();
+            }
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool write_exact(int fd, const uint8_t* buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = write(fd, buf + done, len - done);
+        if (n > 0) {
+            done += n;
+        } else if (!(n < 0 && (errno == EAGAIN || errno == EINTR))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool pin_process(int cpu) {
+    if (cpu < 0) return true;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+// First two CPUs this process may run on; the second is -1 with only one
+static void pick_cpus(int& a, int& b) {
+    a = b = -1;
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed)) continue;
+        if (a < 0) {
+            a = cpu;
+        } else {
+            b = cpu;
+            return;
+        }
+    }
+}
+
+static bool run_pingpong(size_t size, bool busy, int parent_cpu, int child_cpu, int yield_spins) {
+    int ping[2], pong[2];
+    if (pipe(ping) == -1 || pipe(pong) == -1) {
+        perror("pipe");
+        return false;
+    }
+    if (busy) {
+        fcntl(ping[0], F_SETFL, O_NONBLOCK);
+        fcntl(pong[0], F_SETFL, O_NONBLOCK);
+    }
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0) {  // Child: echo
+        close(ping[1]);
+        close(pong[0]);
+        pin_process(child_cpu);
+        std::vector<uint8_t> buf(size);
+        while (read_exact(ping[0], buf.data(), size, busy, yield_spins) && write_exact(pong[1], buf.data(), size)) {
+        }
+        _exit(0);
+    }
+    close(ping[0]);
+    close(pong[1]);
+    pin_process(parent_cpu);
+
+    std::vector<uint8_t> out(size), in(size);
+    fill_pattern(out.data(), size);
+    HdrHistogram hist;
+    int mismatches = 0;
+    for (int round = 0; round < PINGPONG_WARMUP + PINGPONG_ROUNDS; round++) {
+        std::memcpy(out.data(), &round, std::min(size, sizeof(round)));
+        int64_t start = monotonic_ns();
+        if (!write_exact(ping[1], out.data(), size) || !read_exact(pong[0], in.data(), size, busy, yield_spins)) {
+            mismatches++;
+            break;
+        }
+        int64_t rtt = monotonic_ns() - start;
+        if (std::memcmp(out.data(), in.data(), size) != 0) mismatches++;
+        if (round >= PINGPONG_WARMUP) hist.record((uint64_t)rtt);
+    }
+    close(ping[1]);
+    close(pong[0]);
+    waitpid(pid, nullptr, 0);
+
+    std::printf("mode=pingpong size=%zu poll=%s pin=%d,%d rounds=%llu mean_ns=%.0f p50_ns=%llu p90_ns=%llu "
+                "p99_ns=%llu p99_9_ns=%llu max_ns=%llu status=%s\n",
+                size, busy ? "busy" : "block", parent_cpu, child_cpu, (unsigned long long)hist.count(), hist.mean(),
+                (unsigned long long)hist.percentile(50), (unsigned long long)hist.percentile(90),
+                (unsigned long long)hist.percentile(99), (unsigned long long)hist.percentile(99.9),
+                (unsigned long long)hist.max(), mismatches == 0 ? "OK" : "MISMATCH");
+    std::fflush(stdout);
+    return mismatches == 0;
+}
+
+static int run_pingpong_comparison(bool busy, bool pin) {
+    int parent_cpu = -1, child_cpu = -1;
+    cpu_set_t original;
+    sched_getaffinity(0, sizeof(original), &original);
+    int first = -1, second = -1;
+    pick_cpus(first, second);
+    if (pin) {
+        parent_cpu = first;
+        child_cpu = second >= 0 ? second : first;
+    }
+    // Pure spinning only makes sense with a CPU per side
+    int yield_spins = 0;
+    if (busy && second < 0) {
+        std::printf("note: only one CPU allowed, busy-poll yields every %d spins\n", BUSY_POLL_YIELD);
+        yield_spins = BUSY_POLL_YIELD;
+    }
+    std::printf("=== Ping-pong: %d rounds after %d warm-up, poll=%s ===\n", PINGPONG_ROUNDS, PINGPONG_WARMUP,
+                busy ? "busy" : "block");
+    bool ok = true;
+    for (size_t size : PINGPONG_SIZES) {
+        ok &= run_pingpong(size, busy, parent_cpu, child_cpu, yield_spins);
+    }
+    sched_setaffinity(0, sizeof(original), &original);
+    return ok ? 0 : 1;
+}
+
+// Sweep mode: write/read throughput for every message size x pipe capacity.
+// Small messages are syscall-bound and reach steady state quickly, so each
+// point moves SWEEP_BYTES rather than the full 10 GiB.
+static constexpr size_t SWEEP_MIN_MESSAGE = 64;
+static constexpr size_t SWEEP_MAX_MESSAGE = 4 << 20;
+static constexpr size_t SWEEP_MIN_PIPE = 4096;
+static constexpr uint64_t SWEEP_BYTES = 256ULL << 20;
+
+static void print_size(size_t bytes) {
+    if (bytes >= (1 << 20)) {
+        std::printf("%9zuM", bytes >> 20);
+    } else if (bytes >= 1024) {
+        std::printf("%9zuK", bytes >> 10);
+    } else {
+        std::printf("%10zu", bytes);
+    }
+}
+
+static int run_size_sweep(uint64_t bytes_per_point) {
+    std::vector<size_t> messages;
+    for (size_t m = SWEEP_MIN_MESSAGE; m <= SWEEP_MAX_MESSAGE; m *= 4) messages.push_back(m);
+    // Powers of 4 from one page, always ending at pipe-max-size
+    std::vector<size_t> pipes;
+    size_t max_pipe = pipe_max_size();
+    for (size_t p = SWEEP_MIN_PIPE; p < max_pipe; p *= 4) pipes.push_back(p);
+    pipes.push_back(max_pipe);
+
+    std::printf("=== Sweep: %llu bytes per point, message size x F_SETPIPE_SZ ===\n",
+                (unsigned long long)bytes_per_point);
+    std::vector<std::vector<double>> gbps(messages.size(), std::vector<double>(pipes.size(), 0.0));
+    bool ok = true;
+    for (size_t mi = 0; mi < messages.size(); mi++) {
+        for (size_t pi = 0; pi < pipes.size(); pi++) {
+            PipeTransfer t{WriterKind::Write, ReaderKind::Read, messages[mi], pipes[pi], 0, bytes_per_point};
+            TransferStats stats;
+            bool point_ok = run_pipe_transfer("sweep", t, &stats);
+            ok &= point_ok;
+            if (point_ok) gbps[mi][pi] = (bytes_per_point / 1024.0 / 1024.0 / 1024.0) / (stats.elapsed_ms / 1000.0);
+        }
+    }
+
+    std::printf("\nThroughput (GB/s), rows: message size, columns: pipe capacity\n");
+    std::printf("%10s", "msg\\pipe");
+    for (size_t p : pipes) print_size(p);
+    std::printf("\n");
+    for (size_t mi = 0; mi < messages.size(); mi++) {
+        print_size(messages[mi]);
+        for (size_t pi = 0; pi < pipes.size(); pi++) {
+            if (gbps[mi][pi] > 0) {
+                std::printf("%10.3f", gbps[mi][pi]);
+            } else {
+                std::printf("%10s", "fail");
+            }
+        }
+        std::printf("\n");
+    }
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "splice") == 0) {
+        return run_splice_comparison();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "uring") == 0) {
+        unsigned depth = argc > 2 ? (unsigned)std::strtoul(argv[2], nullptr, 10) : URING_QUEUE_DEPTH;
+        return run_uring_comparison(depth > 0 ? depth : URING_QUEUE_DEPTH);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "sweep") == 0) {
+        uint64_t bytes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : SWEEP_BYTES;
+        return run_size_sweep(bytes > 0 ? bytes : SWEEP_BYTES);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "verify") == 0) {
+        return run_verify_comparison();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "multi") == 0) {
+        int cores = std::max(1, (int)std::thread::hardware_concurrency());
+        int streams = argc > 2 ? std::atoi(argv[2]) : cores;
+        return run_multi_comparison(streams > 0 ? streams : cores);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "pingpong") == 0) {
+        bool busy = false, pin = false;
+        for (int i = 2; i < argc; i++) {
+            busy |= std::strcmp(argv[i], "busy") == 0;
+            pin |= std::strcmp(argv[i], "pin") == 0;
+        }
+        return run_pingpong_comparison(busy, pin);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "ipc") == 0) {
+        return run_ipc_comparison();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "shm") == 0) {
+        return run_shm_comparison();
+    }
+    return run_standard();
+}
@@ -0,0 +1,82 @@
+#ifndef HDR_HISTOGRAM_HPP
+#define HDR_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Log-linear (HDR-style) histogram of nanosecond values
+//
+// Values below 2^SUB_BUCKET_BITS are recorded exactly; above that every
+// power of two is split into 2^(SUB_BUCKET_BITS-1) linear sub-buckets, so
+// the relative error stays around 3% across the whole 64-bit range with a
+// fixed ~15 KiB footprint. record() is a few shifts and one increment, cheap
+// enough for every operation. Each thread owns one histogram; merge() folds
+// them together once the run is over.
+//
+// Copy of lock-free-queue/hdr_histogram.hpp: each benchmark directory is
+// its own Docker build context, so keep the two in sync by hand.
+
+class HdrHistogram {
+public:
+    HdrHistogram() : counts_(NUM_BUCKETS, 0) {}
+
+    void record(uint64_t v) {
+        counts_[bucket_of(v)]++;
+        total_++;
+        sum_ += v;
+        max_ = std::max(max_, v);
+    }
+
+    void merge(const HdrHistogram& other) {
+        for (size_t i = 0; i < NUM_BUCKETS; i++) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        sum_ += other.sum_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    // Value at percentile p (0-100): the midpoint of the bucket that holds it
+    uint64_t percentile(double p) const {
+        if (total_ == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(p / 100.0 * total_ + 0.999999);
+        target = std::max<uint64_t>(target, 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; i++) {
+            seen += counts_[i];
+            if (seen >= target) return std::min(value_of(i), max_);
+        }
+        return max_;
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t max() const { return max_; }
+    double mean() const { return total_ ? static_cast<double>(sum_) / total_ : 0.0; }
+
+private:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+    static constexpr size_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+    static constexpr size_t NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 2) * HALF_SUB_BUCKETS;
+
+    static size_t bucket_of(uint64_t v) {
+        if (v < SUB_BUCKETS) return static_cast<size_t>(v);
+        unsigned shift = 63 - __builtin_clzll(v) - (SUB_BUCKET_BITS - 1);
+        return shift * HALF_SUB_BUCKETS + static_cast<size_t>(v >> shift);
+    }
+
+    static uint64_t value_of(size_t idx) {
+        if (idx < SUB_BUCKETS) return idx;
+        size_t shift = idx / HALF_SUB_BUCKETS - 1;
+        uint64_t mantissa = idx - shift * HALF_SUB_BUCKETS;
+        return (mantissa << shift) + ((uint64_t{1} << shift) >> 1);
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t max_ = 0;
+};
+
+#endif
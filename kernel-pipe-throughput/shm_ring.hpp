@@ -0,0 +1,189 @@
+#ifndef SHM_RING_HPP
+#define SHM_RING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define SPIN_PAUSE() _mm_pause()
+#elif defined(__aarch64__)
+  #define SPIN_PAUSE() __asm__ __volatile__("isb")
+#else
+  #define SPIN_PAUSE() ((void)0)
+#endif
+
+// Single-producer/single-consumer byte ring in shared memory
+//
+// The ring lives in a memfd that is mapped MAP_SHARED before fork(), so the
+// writer and reader processes see the same pages. The data area is mapped
+// twice back to back, which makes every reserve()/peek() region contiguous
+// even when it wraps, so callers never split a chunk.
+//
+// head and tail are free-running 64-bit byte positions. Each side caches
+// the other's position and only reloads the shared one when the cached
+// value says the ring is full (producer) or empty (consumer).
+//
+// Zero-copy API: the producer reserve()s space, writes its data in place
+// and commit()s it; the consumer peek()s at the readable bytes, processes
+// them in place and release()s them.
+
+static constexpr int SHM_SPIN_LIMIT = 256;
+
+// Wake-up for one waiting process. The waiter announces itself in
+// `waiting`, rechecks its condition and sleeps on `seq`; the notifier only
+// pays for FUTEX_WAKE when someone is actually waiting. The futex is
+// process-shared (no FUTEX_PRIVATE_FLAG) because the two sides are
+// separate processes.
+struct alignas(64) ShmSignal {
+    std::atomic<uint32_t> seq{0};
+    std::atomic<uint32_t> waiting{0};
+
+    template <typename Ready>
+    void wait_until(Ready&& ready) {
+        for (int i = 0; i < SHM_SPIN_LIMIT; i++) {
+            if (ready()) return;
+            SPIN_PAUSE();
+        }
+        for (;;) {
+            waiting.store(1, std::memory_order_seq_cst);
+            uint32_t key = seq.load(std::memory_order_seq_cst);
+            if (ready()) break;
+            syscall(SYS_futex, &seq, FUTEX_WAIT, key, nullptr, nullptr, 0);
+        }
+        waiting.store(0, std::memory_order_relaxed);
+    }
+
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) == 0) return;
+        seq.fetch_add(1, std::memory_order_acq_rel);
+        syscall(SYS_futex, &seq, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    }
+};
+
+struct ShmRingHeader {
+    alignas(64) std::atomic<uint64_t> tail;  // Written by the producer
+    alignas(64) std::atomic<uint64_t> head;  // Written by the consumer
+    alignas(64) std::atomic<uint32_t> closed;
+    ShmSignal data_ready;   // Consumer waits here
+    ShmSignal space_ready;  // Producer waits here
+};
+
+class ShmRing {
+public:
+    ShmRing() = default;
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    ~ShmRing() {
+        if (data_) munmap(data_, 2 * capacity_);
+        if (hdr_) munmap(hdr_, HEADER_BYTES);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    // Call before fork(). capacity: a power of two and a multiple of the page size.
+    bool create(size_t capacity) {
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        fd_ = (int)syscall(SYS_memfd_create, "shm_ring", 0);
+        if (fd_ < 0 || ftruncate(fd_, HEADER_BYTES + capacity) != 0) {
+            perror("memfd");
+            return false;
+        }
+        void* hdr = mmap(nullptr, HEADER_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (hdr == MAP_FAILED) {
+            perror("mmap header");
+            return false;
+        }
+        hdr_ = new (hdr) ShmRingHeader();
+
+        // Reserve 2 * capacity of address space, then map the data pages
+        // into both halves
+        void* area = mmap(nullptr, 2 * capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (area == MAP_FAILED) {
+            perror("mmap ring");
+            return false;
+        }
+        data_ = static_cast<uint8_t*>(area);
+        for (int half = 0; half < 2; half++) {
+            void* p = mmap(data_ + half * capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_,
+                           HEADER_BYTES);
+            if (p == MAP_FAILED) {
+                perror("mmap ring");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // Producer: waits for `len` (<= capacity) free bytes and returns where to write them
+    uint8_t* reserve(size_t len) {
+        uint64_t tail = hdr_->tail.load(std::memory_order_relaxed);
+        if (tail + len - cached_head_ > capacity_) {
+            hdr_->space_ready.wait_until([&] {
+                cached_head_ = hdr_->head.load(std::memory_order_acquire);
+                return tail + len - cached_head_ <= capacity_;
+            });
+        }
+        return data_ + (tail & mask_);
+    }
+
+    void commit(size_t len) {
+        hdr_->tail.store(hdr_->tail.load(std::memory_order_relaxed) + len, std::memory_order_release);
+        hdr_->data_ready.notify();
+    }
+
+    void close() {
+        hdr_->closed.store(1, std::memory_order_release);
+        hdr_->data_ready.notify();
+    }
+
+    // Consumer: waits for data and returns up to `max` readable bytes in
+    // `len`; len == 0 once the producer has closed and the ring is drained
+    const uint8_t* peek(size_t max, size_t& len) {
+        uint64_t head = hdr_->head.load(std::memory_order_relaxed);
+        if (cached_tail_ == head) {
+            hdr_->data_ready.wait_until([&] {
+                // Read closed first: a close seen here covers every commit before it
+                bool closed = hdr_->closed.load(std::memory_order_acquire);
+                cached_tail_ = hdr_->tail.load(std::memory_order_acquire);
+                return cached_tail_ != head || closed;
+            });
+        }
+        len = (size_t)std::min<uint64_t>(cached_tail_ - head, max);
+        return data_ + (head & mask_);
+    }
+
+    void release(size_t len) {
+        hdr_->head.store(hdr_->head.load(std::memory_order_relaxed) + len, std::memory_order_release);
+        hdr_->space_ready.notify();
+    }
+
+private:
+    static constexpr size_t HEADER_BYTES = 4096;
+    static_assert(sizeof(ShmRingHeader) <= HEADER_BYTES, "header must fit its page");
+
+    ShmRingHeader* hdr_ = nullptr;
+    uint8_t* data_ = nullptr;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    int fd_ = -1;
+
+    // Process-local: each side of the fork keeps its own copy
+    uint64_t cached_head_ = 0;
+    uint64_t cached_tail_ = 0;
+};
+
+#endif
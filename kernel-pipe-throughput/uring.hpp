@@ -0,0 +1,148 @@
+#ifndef URING_HPP
+#define URING_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Minimal io_uring ring on the raw syscalls (no liburing dependency)
+//
+// One submission and one completion ring shared with the kernel. The
+// application owns the SQ tail and the CQ head; the kernel owns the SQ head
+// and the CQ tail. Each side publishes its index with a release store and
+// reads the other's with an acquire load. SQEs are filled in place and the
+// SQ index array is set to the identity mapping once at setup.
+
+class Uring {
+public:
+    Uring() = default;
+    Uring(const Uring&) = delete;
+    Uring& operator=(const Uring&) = delete;
+
+    ~Uring() {
+        if (sqes_) munmap(sqes_, sqes_bytes_);
+        if (cq_map_ && cq_map_ != sq_map_) munmap(cq_map_, cq_map_bytes_);
+        if (sq_map_) munmap(sq_map_, sq_map_bytes_);
+        if (fd_ >= 0) close(fd_);
+    }
+
+    // False (with errno set) when io_uring is unavailable or disabled
+    bool init(unsigned entries) {
+        io_uring_params p;
+        std::memset(&p, 0, sizeof(p));
+        fd_ = (int)syscall(__NR_io_uring_setup, entries, &p);
+        if (fd_ < 0) return false;
+
+        sq_map_bytes_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_map_bytes_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        if (p.features & IORING_FEAT_SINGLE_MMAP) {
+            if (cq_map_bytes_ > sq_map_bytes_) sq_map_bytes_ = cq_map_bytes_;
+            cq_map_bytes_ = sq_map_bytes_;
+        }
+        sq_map_ = map(sq_map_bytes_, IORING_OFF_SQ_RING);
+        if (!sq_map_) return false;
+        cq_map_ = (p.features & IORING_FEAT_SINGLE_MMAP) ? sq_map_ : map(cq_map_bytes_, IORING_OFF_CQ_RING);
+        if (!cq_map_) return false;
+        sqes_bytes_ = p.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_bytes_, IORING_OFF_SQES));
+        if (!sqes_) return false;
+
+        char* sq = static_cast<char*>(sq_map_);
+        sq_head_ = reinterpret_cast<std::atomic<unsigned>*>(sq + p.sq_off.head);
+        sq_tail_ = reinterpret_cast<std::atomic<unsigned>*>(sq + p.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sq_entries_ = p.sq_entries;
+        unsigned* array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        for (unsigned i = 0; i < p.sq_entries; i++) array[i] = i;
+
+        char* cq = static_cast<char*>(cq_map_);
+        cq_head_ = reinterpret_cast<std::atomic<unsigned>*>(cq + p.cq_off.head);
+        cq_tail_ = reinterpret_cast<std::atomic<unsigned>*>(cq + p.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        return true;
+    }
+
+    // Registers fixed buffers: IORING_OP_{READ,WRITE}_FIXED then skip the
+    // per-request page pinning and refer to a buffer by index
+    bool register_buffers(const iovec* iovs, unsigned count) {
+        return syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, iovs, count) == 0;
+    }
+
+    // Next free SQE, zeroed; nullptr when the SQ ring is full
+    io_uring_sqe* get_sqe() {
+        unsigned head = sq_head_->load(std::memory_order_acquire);
+        if (sq_local_tail_ - head >= sq_entries_) return nullptr;
+        io_uring_sqe* sqe = &sqes_[sq_local_tail_ & sq_mask_];
+        sq_local_tail_++;
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    void prep_rw(io_uring_sqe* sqe, uint8_t op, int fd, void* addr, unsigned len, unsigned buf_index,
+                 uint64_t user_data) {
+        sqe->opcode = op;
+        sqe->fd = fd;
+        sqe->off = (uint64_t)-1;  // Pipes: no file position
+        sqe->addr = (uint64_t)(uintptr_t)addr;
+        sqe->len = len;
+        sqe->buf_index = (uint16_t)buf_index;
+        sqe->user_data = user_data;
+    }
+
+    // Publishes the prepared SQEs and waits for `wait_nr` completions in
+    // one io_uring_enter. Returns the number submitted or -errno.
+    int submit_and_wait(unsigned wait_nr) {
+        unsigned to_submit = sq_local_tail_ - sq_tail_->load(std::memory_order_relaxed);
+        sq_tail_->store(sq_local_tail_, std::memory_order_release);
+        for (;;) {
+            int ret = (int)syscall(__NR_io_uring_enter, fd_, to_submit, wait_nr,
+                                   wait_nr ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (ret >= 0 || errno != EINTR) return ret >= 0 ? ret : -errno;
+        }
+    }
+
+    // Oldest unconsumed completion, or nullptr; cqe_seen() releases it
+    io_uring_cqe* peek_cqe() {
+        unsigned head = cq_head_->load(std::memory_order_relaxed);
+        if (head == cq_tail_->load(std::memory_order_acquire)) return nullptr;
+        return &cqes_[head & cq_mask_];
+    }
+
+    void cqe_seen() { cq_head_->store(cq_head_->load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+private:
+    void* map(size_t bytes, off_t offset) {
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    int fd_ = -1;
+    void* sq_map_ = nullptr;
+    void* cq_map_ = nullptr;
+    size_t sq_map_bytes_ = 0;
+    size_t cq_map_bytes_ = 0;
+    size_t sqes_bytes_ = 0;
+
+    io_uring_sqe* sqes_ = nullptr;
+    std::atomic<unsigned>* sq_head_ = nullptr;
+    std::atomic<unsigned>* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned sq_local_tail_ = 0;
+
+    io_uring_cqe* cqes_ = nullptr;
+    std::atomic<unsigned>* cq_head_ = nullptr;
+    std::atomic<unsigned>* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+};
+
+#endif
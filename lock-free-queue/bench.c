@@ -31,6 +31,7 @@ typedef struct {
     Cell buffer[QUEUE_SIZE];
     _Alignas(64) _Atomic uint64_t enqueue_pos;
     _Alignas(64) _Atomic uint64_t dequeue_pos;
+    _Alignas(64) _Atomic int closed;
 } Queue;
 
 void queue_init(Queue* q) {
@@ -40,6 +41,17 @@ void queue_init(Queue* q) {
     }
     atomic_store_explicit(&q->enqueue_pos, 0, memory_order_relaxed);
     atomic_store_explicit(&q->dequeue_pos, 0, memory_order_relaxed);
+    atomic_store_explicit(&q->closed, 0, memory_order_relaxed);
+}
+
+// Close/drain protocol: called once every producer has returned. A consumer
+// that saw the queue closed before a failed dequeue knows it is drained.
+void queue_close(Queue* q) {
+    atomic_store_explicit(&q->closed, 1, memory_order_release);
+}
+
+int queue_is_closed(Queue* q) {
+    return atomic_load_explicit(&q->closed, memory_order_acquire);
 }
 
 int queue_enqueue(Queue* q, uint64_t data) {
@@ -105,8 +117,6 @@ int queue_dequeue(Queue* q, uint64_t* data) {
 
 typedef struct {
     Queue* queue;
-    _Atomic uint64_t* total_consumed;
-    uint64_t expected_total;
     int id;
     uint64_t sum;
     uint64_t ops_completed;
@@ -142,12 +152,14 @@ void* consumer_thread(void* arg) {
     uint64_t sum = 0;
     uint64_t ops = 0;
 
-    while (atomic_load_explicit(ta->total_consumed, memory_order_relaxed) < ta->expected_total) {
+    for (;;) {
+        int closed = queue_is_closed(q);  // Must be read before the dequeue attempt
         uint64_t value;
         if (queue_dequeue(q, &value)) {
             sum += value;
             ops++;
-            atomic_fetch_add_explicit(ta->total_consumed, 1, memory_order_relaxed);
+        } else if (closed) {
+            break;
         } else {
             sched_yield();
         }
@@ -166,9 +178,6 @@ int main(void) {
     }
     queue_init(queue);
 
-    _Atomic uint64_t g_total_consumed = 0;
-    uint64_t expected_total = (uint64_t)NUM_PRODUCERS * OPS_PER_PRODUCER;
-
     pthread_t producers[NUM_PRODUCERS];
     pthread_t consumers[NUM_CONSUMERS];
     ThreadArg producer_args[NUM_PRODUCERS];
@@ -177,16 +186,12 @@ int main(void) {
     // Initialize thread arguments
     for (int i = 0; i < NUM_PRODUCERS; i++) {
         producer_args[i].queue = queue;
-        producer_args[i].total_consumed = &g_total_consumed;
-        producer_args[i].expected_total = expected_total;
         producer_args[i].id = i;
         producer_args[i].sum = 0;
         producer_args[i].ops_completed = 0;
     }
     for (int i = 0; i < NUM_CONSUMERS; i++) {
         consumer_args[i].queue = queue;
-        consumer_args[i].total_consumed = &g_total_consumed;
-        consumer_args[i].expected_total = expected_total;
         consumer_args[i].id = i;
         consumer_args[i].sum = 0;
         consumer_args[i].ops_completed = 0;
@@ -202,10 +207,11 @@ int main(void) {
         pthread_create(&consumers[i], NULL, consumer_thread, &consumer_args[i]);
     }
 
-    // Wait for producers
+    // Wait for producers, then let consumers drain and exit
     for (int i = 0; i < NUM_PRODUCERS; i++) {
         pthread_join(producers[i], NULL);
     }
+    queue_close(queue);
     // Wait for consumers
     for (int i = 0; i < NUM_CONSUMERS; i++) {
         pthread_join(consumers[i], NULL);
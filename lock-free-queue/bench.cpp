@@ -2,135 +2,705 @@
 #include <thread>
 #include <vector>
 #include <chrono>
+#include <algorithm>
 #include <cstdio>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <new>
+#include <sys/resource.h>
 
-#if defined(__x86_64__) || defined(__i386__)
-  #include <x86intrin.h>
-  #define SPIN_PAUSE() _mm_pause()
-#elif defined(__aarch64__)
-  #define SPIN_PAUSE() __asm__ __volatile__("isb")
-#else
-  #define SPIN_PAUSE() ((void)0)
-#endif
-
-// Bounded MPMC Queue (Dmitry Vyukov algorithm)
-// Lock-free multi-producer multi-consumer queue
+#include "faa_queue.hpp"
+#include "hdr_histogram.hpp"
+#include "queue.hpp"
+#include "segmented_queue.hpp"
+#include "topology.hpp"
+#include "wait_strategy.hpp"
+#include "work_stealing.hpp"
 
 constexpr size_t QUEUE_SIZE = 65536;  // Must be power of 2
-constexpr size_t QUEUE_MASK = QUEUE_SIZE - 1;
 
-struct Cell {
-    std::atomic<uint64_t> sequence;
-    uint64_t data;
+// The standard benchmark queue: uint64_t payloads, MPMC protocol
+using BenchQueue = Queue<uint64_t, QUEUE_SIZE, MPMC>;
+
+// Benchmark configuration
+constexpr int NUM_PRODUCERS = 4;
+constexpr int NUM_CONSUMERS = 4;
+constexpr uint64_t OPS_PER_PRODUCER = 1000000;
+
+struct ThreadResult {
+    uint64_t sum = 0;
+    uint64_t ops_completed = 0;
 };
 
-struct alignas(64) Queue {
-    Cell buffer[QUEUE_SIZE];
-    alignas(64) std::atomic<uint64_t> enqueue_pos;
-    alignas(64) std::atomic<uint64_t> dequeue_pos;
+// Shared by every queue with enqueue/dequeue/close/is_closed (Queue, ScqQueue)
+template <typename Q>
+void producer_thread(Q* q, int id, uint64_t ops_per_producer, ThreadResult* result) {
+    uint64_t base = static_cast<uint64_t>(id) * ops_per_producer;
+    uint64_t ops = 0;
 
-    Queue() {
-        for (size_t i = 0; i < QUEUE_SIZE; i++) {
-            buffer[i].sequence.store(i, std::memory_order_relaxed);
-            buffer[i].data = 0;
+    for (uint64_t i = 0; i < ops_per_producer; i++) {
+        uint64_t value = base + i + 1;  // Values 1-based
+        while (!q->enqueue(value)) {
+            std::this_thread::yield();
         }
-        enqueue_pos.store(0, std::memory_order_relaxed);
-        dequeue_pos.store(0, std::memory_order_relaxed);
+        ops++;
     }
 
-    bool enqueue(uint64_t data) {
-        Cell* cell;
-        uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    result->ops_completed = ops;
+}
 
-        for (;;) {
-            cell = &buffer[pos & QUEUE_MASK];
-            uint64_t seq = cell->sequence.load(std::memory_order_acquire);
-            int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+// Stops once the queue is closed and drained; counts stay thread-local
+template <typename Q>
+void consumer_thread(Q* q, ThreadResult* result) {
+    uint64_t sum = 0;
+    uint64_t ops = 0;
 
-            if (diff == 0) {
-                if (enqueue_pos.compare_exchange_weak(pos, pos + 1,
-                        std::memory_order_relaxed, std::memory_order_relaxed)) {
-                    break;
-                }
-            } else if (diff < 0) {
-                return false;  // Queue full
-            } else {
-                pos = enqueue_pos.load(std::memory_order_relaxed);
-            }
-            SPIN_PAUSE();
+    for (;;) {
+        bool closed = q->is_closed();  // Must be read before the dequeue attempt
+        uint64_t value;
+        if (q->dequeue(value)) {
+            sum += value;
+            ops++;
+        } else if (closed) {
+            break;
+        } else {
+            std::this_thread::yield();
         }
+    }
 
-        cell->data = data;
-        cell->sequence.store(pos + 1, std::memory_order_release);
-        return true;
+    result->sum = sum;
+    result->ops_completed = ops;
+}
+
+// Previous termination scheme, kept for the 'termination' comparison: every
+// consumer bumps one shared counter per item and stops when it hits the total
+void counted_consumer_thread(BenchQueue* q, std::atomic<uint64_t>* total_consumed, uint64_t expected_total,
+                             ThreadResult* result) {
+    uint64_t sum = 0;
+    uint64_t ops = 0;
+
+    while (total_consumed->load(std::memory_order_relaxed) < expected_total) {
+        uint64_t value;
+        if (q->dequeue(value)) {
+            sum += value;
+            ops++;
+            total_consumed->fetch_add(1, std::memory_order_relaxed);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    result->sum = sum;
+    result->ops_completed = ops;
+}
+
+uint64_t expected_checksum(int producers, uint64_t ops_per_producer = OPS_PER_PRODUCER) {
+    uint64_t expected_sum = 0;
+    for (int i = 0; i < producers; i++) {
+        uint64_t base = static_cast<uint64_t>(i) * ops_per_producer;
+        expected_sum += ops_per_producer * base + ops_per_producer * (ops_per_producer + 1) / 2;
     }
+    return expected_sum;
+}
 
-    bool dequeue(uint64_t& data) {
-        Cell* cell;
-        uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+// Bulk mode: ops/sec against batch size and producer/consumer contention
+constexpr size_t BULK_BATCH_SIZES[] = {1, 4, 16, 64, 256};
+constexpr int BULK_THREAD_COUNTS[] = {1, 2, 4, 8};  // producers == consumers
+constexpr size_t MAX_BULK_BATCH = 256;
 
-        for (;;) {
-            cell = &buffer[pos & QUEUE_MASK];
-            uint64_t seq = cell->sequence.load(std::memory_order_acquire);
-            int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1);
+void bulk_producer_thread(BenchQueue* q, int id, size_t batch, ThreadResult* result) {
+    uint64_t base = static_cast<uint64_t>(id) * OPS_PER_PRODUCER;
+    uint64_t items[MAX_BULK_BATCH];
+    uint64_t next = 0;
 
-            if (diff == 0) {
-                if (dequeue_pos.compare_exchange_weak(pos, pos + 1,
-                        std::memory_order_relaxed, std::memory_order_relaxed)) {
-                    break;
-                }
-            } else if (diff < 0) {
-                return false;  // Queue empty
-            } else {
-                pos = dequeue_pos.load(std::memory_order_relaxed);
-            }
-            SPIN_PAUSE();
+    while (next < OPS_PER_PRODUCER) {
+        size_t n = 0;
+        for (; n < batch && next + n < OPS_PER_PRODUCER; n++) {
+            items[n] = base + next + n + 1;
+        }
+        size_t done = 0;
+        while (done < n) {
+            size_t k = q->enqueue_bulk(items + done, n - done);
+            if (k == 0) std::this_thread::yield();
+            done += k;
+        }
+        next += n;
+    }
+
+    result->ops_completed = next;
+}
+
+void bulk_consumer_thread(BenchQueue* q, size_t batch, ThreadResult* result) {
+    uint64_t items[MAX_BULK_BATCH];
+    uint64_t sum = 0;
+    uint64_t ops = 0;
+
+    for (;;) {
+        bool closed = q->is_closed();
+        size_t n = q->dequeue_bulk(items, batch);
+        if (n == 0) {
+            if (closed) break;
+            std::this_thread::yield();
+            continue;
         }
+        for (size_t i = 0; i < n; i++) sum += items[i];
+        ops += n;
+    }
+
+    result->sum = sum;
+    result->ops_completed = ops;
+}
+
+int run_bulk_sweep(BenchQueue* queue) {
+    bool all_ok = true;
+
+    for (int threads : BULK_THREAD_COUNTS) {
+        for (size_t batch : BULK_BATCH_SIZES) {
+            new (queue) BenchQueue();
+            uint64_t expected_total = threads * OPS_PER_PRODUCER;
+
+            std::vector<std::thread> producers;
+            std::vector<std::thread> consumers;
+            std::vector<ThreadResult> producer_results(threads);
+            std::vector<ThreadResult> consumer_results(threads);
 
-        data = cell->data;
-        cell->sequence.store(pos + QUEUE_SIZE, std::memory_order_release);
-        return true;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < threads; i++) {
+                producers.emplace_back(bulk_producer_thread, queue, i, batch, &producer_results[i]);
+            }
+            for (int i = 0; i < threads; i++) {
+                consumers.emplace_back(bulk_consumer_thread, queue, batch, &consumer_results[i]);
+            }
+            for (auto& t : producers) {
+                t.join();
+            }
+            queue->close();
+            for (auto& t : consumers) {
+                t.join();
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+            uint64_t consumed = 0;
+            uint64_t sum = 0;
+            for (const auto& r : consumer_results) {
+                consumed += r.ops_completed;
+                sum += r.sum;
+            }
+            uint64_t expected_sum = expected_checksum(threads);
+            bool ok = (sum == expected_sum) && (consumed == expected_total);
+            all_ok = all_ok && ok;
+
+            std::printf("mode=bulk producers=%d consumers=%d batch=%zu elapsed_ms=%.3f ops_per_sec=%.0f checksum=%lu expected=%lu status=%s\n",
+                        threads, threads, batch, elapsed_ms, consumed / (elapsed_ms / 1000.0),
+                        sum, expected_sum, ok ? "OK" : "MISMATCH");
+            queue->~BenchQueue();
+        }
     }
+    return all_ok ? 0 : 1;
+}
+
+// Unbounded mode: bursty producers against the bounded BenchQueue and the
+// SegmentedQueue, sampling each queue's memory footprint while it runs
+constexpr uint64_t BURST_SIZE = 100000;
+constexpr int BURST_PAUSE_US = 2000;
+constexpr int FOOTPRINT_SAMPLE_MS = 5;
+
+struct BoundedAdapter {
+    BenchQueue* q;
+    struct Local {
+        BenchQueue* q;
+        bool enqueue(uint64_t v) { return q->enqueue(v); }
+        bool dequeue(uint64_t& v) { return q->dequeue(v); }
+    };
+    Local local() { return Local{q}; }
+    void close() { q->close(); }
+    bool is_closed() const { return q->is_closed(); }
+    uint64_t footprint_bytes() const { return sizeof(BenchQueue); }
 };
 
-// Benchmark configuration
-constexpr int NUM_PRODUCERS = 4;
-constexpr int NUM_CONSUMERS = 4;
-constexpr uint64_t OPS_PER_PRODUCER = 1000000;
+struct SegmentedAdapter {
+    SegmentedQueue* q;
+    struct Local {
+        SegmentedQueue* q;
+        SegmentedQueue::Handle h;
+        explicit Local(SegmentedQueue* queue) : q(queue), h(queue) {}
+        bool enqueue(uint64_t v) { q->enqueue(h, v); return true; }
+        bool dequeue(uint64_t& v) { return q->dequeue(h, v); }
+    };
+    Local local() { return Local(q); }
+    void close() { q->close(); }
+    bool is_closed() const { return q->is_closed(); }
+    uint64_t footprint_bytes() const { return q->footprint_bytes(); }
+};
 
-struct ThreadResult {
+template <typename Adapter>
+void bursty_producer_thread(Adapter* a, int id, ThreadResult* result) {
+    auto local = a->local();
+    uint64_t base = static_cast<uint64_t>(id) * OPS_PER_PRODUCER;
+    uint64_t i = 0;
+
+    while (i < OPS_PER_PRODUCER) {
+        for (uint64_t end = std::min(i + BURST_SIZE, OPS_PER_PRODUCER); i < end; i++) {
+            while (!local.enqueue(base + i + 1)) {
+                std::this_thread::yield();
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(BURST_PAUSE_US));
+    }
+
+    result->ops_completed = i;
+}
+
+// Same close/drain termination as consumer_thread
+template <typename Adapter>
+void bursty_consumer_thread(Adapter* a, ThreadResult* result) {
+    auto local = a->local();
     uint64_t sum = 0;
-    uint64_t ops_completed = 0;
+    uint64_t ops = 0;
+
+    for (;;) {
+        bool closed = a->is_closed();  // Must be read before the dequeue attempt
+        uint64_t value;
+        if (local.dequeue(value)) {
+            sum += value;
+            ops++;
+        } else if (closed) {
+            break;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    result->sum = sum;
+    result->ops_completed = ops;
+}
+
+template <typename Adapter>
+bool run_bursty(const char* name, Adapter& adapter) {
+    constexpr uint64_t expected_total = NUM_PRODUCERS * OPS_PER_PRODUCER;
+    std::vector<std::thread> producers;
+    std::vector<std::thread> consumers;
+    std::vector<ThreadResult> producer_results(NUM_PRODUCERS);
+    std::vector<ThreadResult> consumer_results(NUM_CONSUMERS);
+
+    std::atomic<bool> done{false};
+    std::vector<uint64_t> samples;
+    std::thread sampler([&] {
+        while (!done.load(std::memory_order_relaxed)) {
+            samples.push_back(adapter.footprint_bytes());
+            std::this_thread::sleep_for(std::chrono::milliseconds(FOOTPRINT_SAMPLE_MS));
+        }
+    });
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NUM_PRODUCERS; i++) {
+        producers.emplace_back(bursty_producer_thread<Adapter>, &adapter, i, &producer_results[i]);
+    }
+    for (int i = 0; i < NUM_CONSUMERS; i++) {
+        consumers.emplace_back(bursty_consumer_thread<Adapter>, &adapter, &consumer_results[i]);
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    adapter.close();
+    for (auto& t : consumers) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    done.store(true);
+    sampler.join();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    uint64_t consumed = 0;
+    uint64_t sum = 0;
+    for (const auto& r : consumer_results) {
+        consumed += r.ops_completed;
+        sum += r.sum;
+    }
+    uint64_t expected_sum = expected_checksum(NUM_PRODUCERS);
+    bool ok = (sum == expected_sum) && (consumed == expected_total);
+
+    uint64_t peak = 0;
+    double mean = 0.0;
+    for (uint64_t b : samples) {
+        peak = std::max(peak, b);
+        mean += static_cast<double>(b) / samples.size();
+    }
+
+    std::printf("mode=unbounded queue=%s elapsed_ms=%.3f ops_per_sec=%.0f peak_bytes=%lu mean_bytes=%.0f final_bytes=%lu checksum=%lu expected=%lu status=%s\n",
+                name, elapsed_ms, consumed / (elapsed_ms / 1000.0), peak, mean, adapter.footprint_bytes(),
+                sum, expected_sum, ok ? "OK" : "MISMATCH");
+    std::printf("footprint queue=%s interval_ms=%d kib=", name, FOOTPRINT_SAMPLE_MS);
+    for (size_t i = 0; i < samples.size(); i++) {
+        std::printf("%s%lu", i ? "," : "", samples[i] / 1024);
+    }
+    std::printf("\n");
+    return ok;
+}
+
+int run_unbounded_comparison(BenchQueue* queue) {
+    new (queue) BenchQueue();
+    BoundedAdapter bounded{queue};
+    bool ok = run_bursty("bounded", bounded);
+    queue->~BenchQueue();
+
+    SegmentedQueue* segmented = new SegmentedQueue();
+    SegmentedAdapter unbounded{segmented};
+    ok = run_bursty("segmented", unbounded) && ok;
+    delete segmented;
+
+    return ok ? 0 : 1;
+}
+
+// Policy mode: each cardinality specialization with 8, 64 and 256 byte payloads
+
+// Move-only payload of Bytes bytes; words[0] carries the checksum value
+template <size_t Bytes>
+struct Payload {
+    static_assert(Bytes % sizeof(uint64_t) == 0, "Payload size must be a multiple of 8");
+    uint64_t words[Bytes / sizeof(uint64_t)];
+
+    Payload() = default;
+    explicit Payload(uint64_t v) {
+        for (auto& w : words) w = v;
+    }
+    Payload(Payload&& other) noexcept { *this = std::move(other); }
+    Payload& operator=(Payload&& other) noexcept {
+        std::memcpy(words, other.words, sizeof(words));
+        other.words[0] = 0;
+        return *this;
+    }
+    Payload(const Payload&) = delete;
+    Payload& operator=(const Payload&) = delete;
+
+    uint64_t value() const { return words[0]; }
 };
 
-void producer_thread(Queue* q, int id, ThreadResult* result) {
+template <>
+struct Payload<8> {
+    uint64_t v = 0;
+
+    Payload() = default;
+    explicit Payload(uint64_t value) : v(value) {}
+    Payload(Payload&& other) noexcept : v(other.v) { other.v = 0; }
+    Payload& operator=(Payload&& other) noexcept { v = other.v; other.v = 0; return *this; }
+    Payload(const Payload&) = delete;
+    Payload& operator=(const Payload&) = delete;
+
+    uint64_t value() const { return v; }
+};
+
+template <typename Q>
+void policy_producer_thread(Q* q, int id, ThreadResult* result) {
     uint64_t base = static_cast<uint64_t>(id) * OPS_PER_PRODUCER;
-    uint64_t ops = 0;
 
     for (uint64_t i = 0; i < OPS_PER_PRODUCER; i++) {
-        uint64_t value = base + i + 1;  // Values 1-based
-        while (!q->enqueue(value)) {
+        while (!q->try_emplace(base + i + 1)) {
+            std::this_thread::yield();
+        }
+    }
+
+    result->ops_completed = OPS_PER_PRODUCER;
+}
+
+template <typename Q, typename T>
+void policy_consumer_thread(Q* q, ThreadResult* result) {
+    uint64_t sum = 0;
+    uint64_t ops = 0;
+    T item;
+
+    for (;;) {
+        bool closed = q->is_closed();
+        if (q->dequeue(item)) {
+            sum += item.value();
+            ops++;
+        } else if (closed) {
+            break;
+        } else {
             std::this_thread::yield();
         }
-        ops++;
     }
 
+    result->sum = sum;
     result->ops_completed = ops;
 }
 
-void consumer_thread(Queue* q, std::atomic<uint64_t>* total_consumed, uint64_t expected_total, ThreadResult* result) {
+template <typename Policy, size_t Bytes>
+bool run_policy(const char* name, int producers, int consumers) {
+    using T = Payload<Bytes>;
+    using Q = Queue<T, QUEUE_SIZE, Policy>;
+
+    void* mem = aligned_alloc(64, sizeof(Q));
+    if (!mem) {
+        std::fprintf(stderr, "Failed to allocate queue\n");
+        return false;
+    }
+    Q* q = new (mem) Q();
+
+    uint64_t expected_total = producers * OPS_PER_PRODUCER;
+    std::vector<std::thread> producer_threads;
+    std::vector<std::thread> consumer_threads;
+    std::vector<ThreadResult> producer_results(producers);
+    std::vector<ThreadResult> consumer_results(consumers);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < producers; i++) {
+        producer_threads.emplace_back(policy_producer_thread<Q>, q, i, &producer_results[i]);
+    }
+    for (int i = 0; i < consumers; i++) {
+        consumer_threads.emplace_back(policy_consumer_thread<Q, T>, q, &consumer_results[i]);
+    }
+    for (auto& t : producer_threads) {
+        t.join();
+    }
+    q->close();
+    for (auto& t : consumer_threads) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    uint64_t consumed = 0;
+    uint64_t sum = 0;
+    for (const auto& r : consumer_results) {
+        consumed += r.ops_completed;
+        sum += r.sum;
+    }
+    uint64_t expected_sum = expected_checksum(producers);
+    bool ok = (sum == expected_sum) && (consumed == expected_total);
+
+    std::printf("mode=policy policy=%s payload_bytes=%zu producers=%d consumers=%d elapsed_ms=%.3f ops_per_sec=%.0f checksum=%lu expected=%lu status=%s\n",
+                name, Bytes, producers, consumers, elapsed_ms, consumed / (elapsed_ms / 1000.0),
+                sum, expected_sum, ok ? "OK" : "MISMATCH");
+
+    q->~Q();
+    free(mem);
+    return ok;
+}
+
+template <size_t Bytes>
+bool run_policies_for_payload() {
+    bool ok = run_policy<SPSC, Bytes>("spsc", 1, 1);
+    ok = run_policy<MPSC, Bytes>("mpsc", NUM_PRODUCERS, 1) && ok;
+    ok = run_policy<MPMC, Bytes>("mpmc", NUM_PRODUCERS, NUM_CONSUMERS) && ok;
+    return ok;
+}
+
+int run_policy_sweep() {
+    bool ok = run_policies_for_payload<8>();
+    ok = run_policies_for_payload<64>() && ok;
+    ok = run_policies_for_payload<256>() && ok;
+    return ok ? 0 : 1;
+}
+
+// Wait mode: wait strategies under a duty-cycled load. Producers send one
+// burst per period and sleep for the rest of it, so consumers spend most of
+// the run waiting on an empty queue.
+constexpr int DUTY_PERIODS = 100;
+constexpr int DUTY_PERIOD_MS = 10;
+constexpr uint64_t DUTY_BURST = 2000;  // Items per producer per period
+constexpr uint64_t DUTY_OPS_PER_PRODUCER = DUTY_PERIODS * DUTY_BURST;
+
+using SteadyClock = std::chrono::steady_clock;
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now().time_since_epoch()).count();
+}
+
+double cpu_time_ms() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+template <typename Wait>
+struct DutyShared {
+    BenchQueue* q;
+    Wait not_empty;
+    Wait not_full;
+    SteadyClock::time_point start;
+    std::atomic<int64_t> burst_start_ns{0};
+};
+
+template <typename Wait>
+void duty_producer_thread(DutyShared<Wait>* s, int id, ThreadResult* result) {
+    uint64_t base = static_cast<uint64_t>(id) * DUTY_OPS_PER_PRODUCER;
+    uint64_t i = 0;
+
+    for (int period = 0; period < DUTY_PERIODS; period++) {
+        std::this_thread::sleep_until(s->start + std::chrono::milliseconds(period * DUTY_PERIOD_MS));
+        s->burst_start_ns.store(now_ns(), std::memory_order_relaxed);
+        for (uint64_t k = 0; k < DUTY_BURST; k++, i++) {
+            uint64_t value = base + i + 1;
+            s->not_full.wait_until([&] { return s->q->enqueue(value); });
+            s->not_empty.notify_one();
+        }
+    }
+
+    result->ops_completed = i;
+}
+
+// Wake-up latency: burst start to the first item of a consumer that was
+// already waiting when the burst began
+template <typename Wait>
+void duty_consumer_thread(DutyShared<Wait>* s, ThreadResult* result, std::vector<int64_t>* wake_ns) {
     uint64_t sum = 0;
     uint64_t ops = 0;
 
-    while (total_consumed->load(std::memory_order_relaxed) < expected_total) {
+    for (;;) {
         uint64_t value;
-        if (q->dequeue(value)) {
-            sum += value;
+        bool got = false;
+        bool waited = false;
+        int64_t wait_begin = 0;
+        s->not_empty.wait_until([&] {
+            bool closed = s->q->is_closed();  // Must be read before the dequeue attempt
+            if (s->q->dequeue(value)) return got = true;
+            if (!waited) {
+                waited = true;
+                wait_begin = now_ns();
+            }
+            return closed;
+        });
+        if (!got) break;
+        s->not_full.notify_one();
+
+        if (waited) {
+            int64_t burst = s->burst_start_ns.load(std::memory_order_relaxed);
+            if (wait_begin < burst) wake_ns->push_back(now_ns() - burst);
+        }
+        sum += value;
+        ops++;
+    }
+
+    result->sum = sum;
+    result->ops_completed = ops;
+}
+
+template <typename Wait>
+bool run_wait_strategy(BenchQueue* queue) {
+    new (queue) BenchQueue();
+    DutyShared<Wait> shared;
+    shared.q = queue;
+    constexpr uint64_t expected_total = NUM_PRODUCERS * DUTY_OPS_PER_PRODUCER;
+
+    std::vector<std::thread> producers;
+    std::vector<std::thread> consumers;
+    std::vector<ThreadResult> producer_results(NUM_PRODUCERS);
+    std::vector<ThreadResult> consumer_results(NUM_CONSUMERS);
+    std::vector<std::vector<int64_t>> wake_ns(NUM_CONSUMERS);
+
+    double cpu_start = cpu_time_ms();
+    auto start = SteadyClock::now();
+    shared.start = start;
+    for (int i = 0; i < NUM_CONSUMERS; i++) {
+        consumers.emplace_back(duty_consumer_thread<Wait>, &shared, &consumer_results[i], &wake_ns[i]);
+    }
+    for (int i = 0; i < NUM_PRODUCERS; i++) {
+        producers.emplace_back(duty_producer_thread<Wait>, &shared, i, &producer_results[i]);
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    queue->close();
+    shared.not_empty.notify_all();  // Release consumers parked on the empty queue
+    for (auto& t : consumers) {
+        t.join();
+    }
+    auto end = SteadyClock::now();
+    double cpu_ms = cpu_time_ms() - cpu_start;
+    double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    uint64_t consumed = 0;
+    uint64_t sum = 0;
+    for (const auto& r : consumer_results) {
+        consumed += r.ops_completed;
+        sum += r.sum;
+    }
+    uint64_t expected_sum = expected_checksum(NUM_PRODUCERS, DUTY_OPS_PER_PRODUCER);
+    bool ok = (sum == expected_sum) && (consumed == expected_total);
+
+    std::vector<int64_t> wakes;
+    for (const auto& w : wake_ns) {
+        wakes.insert(wakes.end(), w.begin(), w.end());
+    }
+    std::sort(wakes.begin(), wakes.end());
+    auto wake_us = [&](double p) {
+        return wakes.empty() ? 0.0 : wakes[static_cast<size_t>(p * (wakes.size() - 1))] / 1000.0;
+    };
+
+    std::printf("mode=wait strategy=%s producers=%d consumers=%d elapsed_ms=%.3f ops_per_sec=%.0f cpu_ms=%.1f cpu_util=%.2f wakes=%zu wake_p50_us=%.1f wake_p99_us=%.1f wake_max_us=%.1f checksum=%lu expected=%lu status=%s\n",
+                Wait::name, NUM_PRODUCERS, NUM_CONSUMERS, elapsed_ms, consumed / (elapsed_ms / 1000.0),
+                cpu_ms, cpu_ms / elapsed_ms, wakes.size(), wake_us(0.50), wake_us(0.99), wake_us(1.0),
+                sum, expected_sum, ok ? "OK" : "MISMATCH");
+    queue->~BenchQueue();
+    return ok;
+}
+
+int run_wait_comparison(BenchQueue* queue) {
+    bool ok = run_wait_strategy<SpinWait>(queue);
+    ok = run_wait_strategy<SpinYieldWait>(queue) && ok;
+    ok = run_wait_strategy<SpinFutexWait>(queue) && ok;
+    return ok ? 0 : 1;
+}
+
+// Latency mode: producers stamp every item with the steady clock (vDSO, no
+// syscall), consumers record enqueue-to-dequeue delay into their own
+// histogram; the histograms are merged once all threads have joined.
+//
+// The load is closed-loop: at most `window` items are in the queue at once.
+// An open-loop producer keeps the queue full, and every sample then measures
+// the drain time of 64K items ahead of it rather than the handoff.
+constexpr uint64_t LATENCY_WINDOWS[] = {1, 16, 256};
+
+struct StampedItem {
+    uint64_t value;
+    int64_t enqueued_ns;
+};
+
+using LatencyQueue = Queue<StampedItem, QUEUE_SIZE, MPMC>;
+
+// Producers take a ticket and wait until all but window - 1 of the items
+// before it have been dequeued
+struct LatencyWindow {
+    uint64_t window;
+    alignas(64) std::atomic<uint64_t> produced{0};
+    alignas(64) std::atomic<uint64_t> consumed{0};
+};
+
+void latency_producer_thread(LatencyQueue* q, LatencyWindow* w, int id, ThreadResult* result) {
+    uint64_t base = static_cast<uint64_t>(id) * OPS_PER_PRODUCER;
+
+    for (uint64_t i = 0; i < OPS_PER_PRODUCER; i++) {
+        uint64_t value = base + i + 1;
+        uint64_t ticket = w->produced.fetch_add(1, std::memory_order_relaxed);
+        while (ticket - w->consumed.load(std::memory_order_acquire) >= w->window) {
+            std::this_thread::yield();
+        }
+        while (!q->try_emplace(StampedItem{value, now_ns()})) {
+            std::this_thread::yield();
+        }
+    }
+
+    result->ops_completed = OPS_PER_PRODUCER;
+}
+
+void latency_consumer_thread(LatencyQueue* q, LatencyWindow* w, ThreadResult* result, HdrHistogram* hist) {
+    uint64_t sum = 0;
+    uint64_t ops = 0;
+
+    for (;;) {
+        bool closed = q->is_closed();
+        StampedItem item;
+        if (q->dequeue(item)) {
+            hist->record(static_cast<uint64_t>(now_ns() - item.enqueued_ns));
+            w->consumed.fetch_add(1, std::memory_order_release);
+            sum += item.value;
             ops++;
-            total_consumed->fetch_add(1, std::memory_order_relaxed);
+        } else if (closed) {
+            break;
         } else {
             std::this_thread::yield();
         }
@@ -140,17 +710,620 @@ void consumer_thread(Queue* q, std::atomic<uint64_t>* total_consumed, uint64_t e
     result->ops_completed = ops;
 }
 
-int main() {
-    // Aligned allocation for cache efficiency
-    void* mem = aligned_alloc(64, sizeof(Queue));
+bool run_latency(int producers, int consumers, uint64_t window) {
+    void* mem = aligned_alloc(64, sizeof(LatencyQueue));
     if (!mem) {
         std::fprintf(stderr, "Failed to allocate queue\n");
+        return false;
+    }
+    LatencyQueue* q = new (mem) LatencyQueue();
+    LatencyWindow w;
+    w.window = window;
+
+    uint64_t expected_total = producers * OPS_PER_PRODUCER;
+    std::vector<std::thread> producer_threads;
+    std::vector<std::thread> consumer_threads;
+    std::vector<ThreadResult> producer_results(producers);
+    std::vector<ThreadResult> consumer_results(consumers);
+    std::vector<HdrHistogram> histograms(consumers);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < producers; i++) {
+        producer_threads.emplace_back(latency_producer_thread, q, &w, i, &producer_results[i]);
+    }
+    for (int i = 0; i < consumers; i++) {
+        consumer_threads.emplace_back(latency_consumer_thread, q, &w, &consumer_results[i], &histograms[i]);
+    }
+    for (auto& t : producer_threads) {
+        t.join();
+    }
+    q->close();
+    for (auto& t : consumer_threads) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    uint64_t consumed = 0;
+    uint64_t sum = 0;
+    HdrHistogram merged;
+    for (int i = 0; i < consumers; i++) {
+        consumed += consumer_results[i].ops_completed;
+        sum += consumer_results[i].sum;
+        merged.merge(histograms[i]);
+    }
+    uint64_t expected_sum = expected_checksum(producers);
+    bool ok = (sum == expected_sum) && (consumed == expected_total);
+
+    std::printf("mode=latency producers=%d consumers=%d max_in_flight=%lu elapsed_ms=%.3f ops_per_sec=%.0f samples=%lu mean_ns=%.0f p50_ns=%lu p99_ns=%lu p999_ns=%lu max_ns=%lu checksum=%lu expected=%lu status=%s\n",
+                producers, consumers, window, elapsed_ms, consumed / (elapsed_ms / 1000.0), merged.count(),
+                merged.mean(), merged.percentile(50.0), merged.percentile(99.0), merged.percentile(99.9),
+                merged.max(), sum, expected_sum, ok ? "OK" : "MISMATCH");
+
+    q->~LatencyQueue();
+    free(mem);
+    return ok;
+}
+
+int run_latency_comparison() {
+    bool ok = true;
+    for (uint64_t window : LATENCY_WINDOWS) {
+        ok = run_latency(1, 1, window) && ok;
+        ok = run_latency(NUM_PRODUCERS, NUM_CONSUMERS, window) && ok;
+    }
+    return ok ? 0 : 1;
+}
+
+// Sweep mode: producers x consumers from 1x1 up to every allowed CPU (half
+// of them per side when pinned), once per pinning policy, printed as one
+// scaling table per policy
+constexpr uint64_t SWEEP_OPS_PER_PRODUCER = 250000;  // Override with ./bench sweep <ops>
+
+struct Placement {
+    const char* name;
+    std::vector<int> producer_cpus;  // Empty: unpinned
+    std::vector<int> consumer_cpus;
+    int max_threads;                 // Per side
+};
+
+// Producer i and consumer i take consecutive CPUs of `order`. The sweep
+// stops at half the CPUs per side, so no CPU runs two threads (a single CPU
+// hosts the 1x1 pair).
+Placement interleaved(const char* name, const std::vector<int>& order) {
+    size_t pairs = std::max<size_t>(1, order.size() / 2);
+    Placement p{name, {}, {}, static_cast<int>(pairs)};
+    for (size_t i = 0; i < pairs; i++) {
+        p.producer_cpus.push_back(order[(2 * i) % order.size()]);
+        p.consumer_cpus.push_back(order[(2 * i + 1) % order.size()]);
+    }
+    return p;
+}
+
+std::vector<Placement> sweep_placements(const std::vector<CpuInfo>& cpus) {
+    std::vector<Placement> placements;
+    std::vector<int> packages = packages_of(cpus);
+    std::printf("topology cpus=%zu sockets=%zu smt=%s\n", cpus.size(), packages.size(), has_smt(cpus) ? "yes" : "no");
+
+    placements.push_back({"unpinned", {}, {}, static_cast<int>(cpus.size())});
+
+    if (has_smt(cpus)) {
+        // Each producer/consumer pair shares a physical core
+        placements.push_back(interleaved("smt_sibling", cpu_order(cpus, -1, true)));
+    } else {
+        std::printf("skip policy=smt_sibling reason=no SMT siblings among allowed CPUs\n");
+    }
+
+    if (cpus.size() >= 2) {
+        // Separate cores of one socket, SMT siblings only once every core is used
+        placements.push_back(interleaved("same_socket", cpu_order(cpus, packages[0], false)));
+    } else {
+        std::printf("skip policy=same_socket reason=needs at least 2 CPUs\n");
+    }
+
+    if (packages.size() >= 2) {
+        std::vector<int> near = cpu_order(cpus, packages[0], false);
+        std::vector<int> far = cpu_order(cpus, packages[1], false);
+        placements.push_back({"cross_socket", near, far, static_cast<int>(std::min(near.size(), far.size()))});
+    } else {
+        std::printf("skip policy=cross_socket reason=single socket\n");
+    }
+    return placements;
+}
+
+std::vector<int> sweep_counts(int max_threads) {
+    std::vector<int> counts;
+    for (int n = 1; n < max_threads; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+bool run_sweep_point(BenchQueue* queue, const Placement& placement, int producers, int consumers,
+                     uint64_t ops_per_producer, double* ops_per_sec) {
+    new (queue) BenchQueue();
+    uint64_t expected_total = producers * ops_per_producer;
+    std::vector<std::thread> producer_threads;
+    std::vector<std::thread> consumer_threads;
+    std::vector<ThreadResult> producer_results(producers);
+    std::vector<ThreadResult> consumer_results(consumers);
+    std::atomic<bool> pin_failed{false};
+
+    auto cpu_for = [](const std::vector<int>& cpus, int i) {
+        return cpus.empty() ? -1 : cpus[i % cpus.size()];
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < producers; i++) {
+        int cpu = cpu_for(placement.producer_cpus, i);
+        producer_threads.emplace_back([=, &pin_failed, &producer_results] {
+            if (!pin_current_thread(cpu)) pin_failed.store(true);
+            producer_thread(queue, i, ops_per_producer, &producer_results[i]);
+        });
+    }
+    for (int i = 0; i < consumers; i++) {
+        int cpu = cpu_for(placement.consumer_cpus, i);
+        consumer_threads.emplace_back([=, &pin_failed, &consumer_results] {
+            if (!pin_current_thread(cpu)) pin_failed.store(true);
+            consumer_thread(queue, &consumer_results[i]);
+        });
+    }
+    for (auto& t : producer_threads) {
+        t.join();
+    }
+    queue->close();
+    for (auto& t : consumer_threads) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    uint64_t consumed = 0;
+    uint64_t sum = 0;
+    for (const auto& r : consumer_results) {
+        consumed += r.ops_completed;
+        sum += r.sum;
+    }
+    uint64_t expected_sum = expected_checksum(producers, ops_per_producer);
+    bool ok = (sum == expected_sum) && (consumed == expected_total);
+    *ops_per_sec = consumed / (elapsed_ms / 1000.0);
+
+    std::printf("mode=sweep policy=%s producers=%d consumers=%d elapsed_ms=%.3f ops_per_sec=%.0f pinned=%s checksum=%lu expected=%lu status=%s\n",
+                placement.name, producers, consumers, elapsed_ms, *ops_per_sec,
+                placement.producer_cpus.empty() ? "no" : (pin_failed.load() ? "failed" : "yes"),
+                sum, expected_sum, ok ? "OK" : "MISMATCH");
+    queue->~BenchQueue();
+    return ok;
+}
+
+int run_contention_sweep(BenchQueue* queue, uint64_t ops_per_producer) {
+    std::vector<CpuInfo> cpus = read_topology();
+    if (cpus.empty()) {
+        std::fprintf(stderr, "Failed to read CPU affinity\n");
         return 1;
     }
-    Queue* queue = new (mem) Queue();
+    bool all_ok = true;
+
+    for (const Placement& placement : sweep_placements(cpus)) {
+        std::vector<int> counts = sweep_counts(placement.max_threads);
+        std::vector<double> table(counts.size() * counts.size());
+        for (size_t p = 0; p < counts.size(); p++) {
+            for (size_t c = 0; c < counts.size(); c++) {
+                all_ok = run_sweep_point(queue, placement, counts[p], counts[c], ops_per_producer,
+                                         &table[p * counts.size() + c]) && all_ok;
+            }
+        }
+
+        std::printf("\nScaling policy=%s (Mops/s, rows = producers, columns = consumers)\n%6s", placement.name, "P\\C");
+        for (int c : counts) std::printf("%9d", c);
+        std::printf("\n");
+        for (size_t p = 0; p < counts.size(); p++) {
+            std::printf("%6d", counts[p]);
+            for (size_t c = 0; c < counts.size(); c++) std::printf("%9.2f", table[p * counts.size() + c] / 1e6);
+            std::printf("\n");
+        }
+        std::printf("\n");
+    }
+    return all_ok ? 0 : 1;
+}
+
+// Tasks mode: fine-grained task parallelism on the work-stealing scheduler
+// vs a task pool built from one shared MPMC Queue.
+//  - mandelbrot: one task per tile, both pools. The scheduler splits the
+//    tile range recursively; the queue pool enqueues every tile up front.
+//  - fib: nested fork/join, work-stealing only. A FIFO shared queue cannot
+//    run it with helping waits: wait() picks up the oldest task, which forks
+//    and waits again, and the stack overflows.
+constexpr int TASK_IMAGE_SIZE = 1024;
+constexpr int TASK_MAX_ITER = 256;
+constexpr int TASK_TILE_SIZES[] = {8, 16, 64};  // Pixels per tile side
+constexpr int TASK_FIB_N = 30;
+constexpr int TASK_FIB_CUTOFFS[] = {4, 10, 16};
+
+using TaskQueue = Queue<Task*, QUEUE_SIZE, MPMC>;
+
+// Baseline: spawn enqueues on the shared queue (runs inline when full), wait
+// and idle workers dequeue from it
+class SharedQueuePool {
+public:
+    static constexpr const char* name = "mpmc_queue";
+
+    explicit SharedQueuePool(int num_threads) : queue_(new TaskQueue()) {
+        for (int i = 1; i < num_threads; i++) {
+            threads_.emplace_back(&SharedQueuePool::worker_loop, this);
+        }
+    }
+
+    ~SharedQueuePool() {
+        stop_.store(true, std::memory_order_relaxed);
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    template <typename F>
+    void run(F&& root) { root(); }
+
+    void spawn(TaskGroup& group, Task& task) {
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+        task.pending = &group.pending;
+        if (!queue_->enqueue(&task)) {
+            run_task(&task);
+        }
+    }
+
+    void wait(TaskGroup& group) {
+        while (group.pending.load(std::memory_order_acquire) > 0) {
+            Task* task;
+            if (queue_->dequeue(task)) {
+                run_task(task);
+            } else {
+                SPIN_PAUSE();
+            }
+        }
+    }
+
+    // Flat: one task per grain-sized chunk, all enqueued before waiting
+    template <typename Body>
+    void parallel_for(int64_t begin, int64_t end, int64_t grain, const Body& body) {
+        struct ChunkTask final : Task {
+            const Body* body;
+            int64_t begin, end;
+            void execute() override {
+                for (int64_t i = begin; i < end; i++) (*body)(i);
+            }
+        };
+        std::vector<ChunkTask> chunks;
+        for (int64_t i = begin; i < end; i += grain) {
+            chunks.emplace_back();
+            chunks.back().body = &body;
+            chunks.back().begin = i;
+            chunks.back().end = std::min(i + grain, end);
+        }
+        TaskGroup group;
+        for (auto& chunk : chunks) {
+            spawn(group, chunk);
+        }
+        wait(group);
+    }
+
+    uint64_t steals() const { return 0; }
+
+private:
+    void worker_loop() {
+        int idle = 0;
+        while (!stop_.load(std::memory_order_relaxed)) {
+            Task* task;
+            if (queue_->dequeue(task)) {
+                run_task(task);
+                idle = 0;
+            } else if (++idle < 64) {
+                SPIN_PAUSE();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::unique_ptr<TaskQueue> queue_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stop_{false};
+};
+
+// Escape-time iterations summed over one tile
+uint64_t mandelbrot_tile(int tile, int tile_size) {
+    int tiles_per_row = TASK_IMAGE_SIZE / tile_size;
+    int x0 = (tile % tiles_per_row) * tile_size;
+    int y0 = (tile / tiles_per_row) * tile_size;
+    uint64_t iterations = 0;
+
+    for (int y = y0; y < y0 + tile_size; y++) {
+        double ci = -1.5 + 3.0 * y / TASK_IMAGE_SIZE;
+        for (int x = x0; x < x0 + tile_size; x++) {
+            double cr = -2.0 + 3.0 * x / TASK_IMAGE_SIZE;
+            double zr = 0.0, zi = 0.0;
+            int it = 0;
+            while (it < TASK_MAX_ITER && zr * zr + zi * zi <= 4.0) {
+                double t = zr * zr - zi * zi + cr;
+                zi = 2.0 * zr * zi + ci;
+                zr = t;
+                it++;
+            }
+            iterations += it;
+        }
+    }
+    return iterations;
+}
 
-    std::atomic<uint64_t> g_total_consumed{0};
+uint64_t fib_serial(int n) {
+    return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+uint64_t fib_task_count(int n, int cutoff) {
+    return n < cutoff ? 0 : 1 + fib_task_count(n - 1, cutoff) + fib_task_count(n - 2, cutoff);
+}
+
+template <typename Pool>
+uint64_t fib_task(Pool& pool, int n, int cutoff) {
+    if (n < cutoff) return fib_serial(n);
+    uint64_t a = 0;
+    TaskGroup group;
+    auto child = make_task([&] { a = fib_task(pool, n - 1, cutoff); });
+    pool.spawn(group, child);
+    uint64_t b = fib_task(pool, n - 2, cutoff);
+    pool.wait(group);
+    return a + b;
+}
+
+template <typename Pool>
+bool run_mandelbrot(int threads, int tile_size, uint64_t expected) {
+    int tiles = (TASK_IMAGE_SIZE / tile_size) * (TASK_IMAGE_SIZE / tile_size);
+    std::vector<uint64_t> tile_iterations(tiles);
+    Pool pool(threads);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    pool.run([&] {
+        pool.parallel_for(0, tiles, 1, [&](int64_t t) {
+            tile_iterations[t] = mandelbrot_tile(static_cast<int>(t), tile_size);
+        });
+    });
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    uint64_t checksum = 0;
+    for (uint64_t it : tile_iterations) checksum += it;
+    bool ok = (checksum == expected);
+
+    std::printf("mode=tasks workload=mandelbrot pool=%s threads=%d tile=%d elapsed_ms=%.3f tasks=%d tasks_per_sec=%.0f steals=%lu checksum=%lu expected=%lu status=%s\n",
+                Pool::name, threads, tile_size, elapsed_ms, tiles, tiles / (elapsed_ms / 1000.0),
+                pool.steals(), checksum, expected, ok ? "OK" : "MISMATCH");
+    return ok;
+}
+
+bool run_fib(int threads, int cutoff) {
+    WorkStealingScheduler pool(threads);
+    uint64_t result = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    pool.run([&] { result = fib_task(pool, TASK_FIB_N, cutoff); });
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    uint64_t expected = fib_serial(TASK_FIB_N);
+    uint64_t tasks = fib_task_count(TASK_FIB_N, cutoff);
+    bool ok = (result == expected);
+
+    std::printf("mode=tasks workload=fib pool=%s threads=%d fib_n=%d cutoff=%d elapsed_ms=%.3f tasks=%lu tasks_per_sec=%.0f steals=%lu checksum=%lu expected=%lu status=%s\n",
+                WorkStealingScheduler::name, threads, TASK_FIB_N, cutoff, elapsed_ms, tasks,
+                tasks / (elapsed_ms / 1000.0), pool.steals(), result, expected, ok ? "OK" : "MISMATCH");
+    return ok;
+}
+
+int run_task_comparison() {
+    int hw = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> thread_counts = {1};
+    if (hw > 1) thread_counts.push_back(hw);
+
+    bool ok = true;
+    for (int tile_size : TASK_TILE_SIZES) {
+        uint64_t expected = 0;
+        for (int t = 0; t < (TASK_IMAGE_SIZE / tile_size) * (TASK_IMAGE_SIZE / tile_size); t++) {
+            expected += mandelbrot_tile(t, tile_size);
+        }
+        for (int threads : thread_counts) {
+            ok = run_mandelbrot<WorkStealingScheduler>(threads, tile_size, expected) && ok;
+            ok = run_mandelbrot<SharedQueuePool>(threads, tile_size, expected) && ok;
+        }
+    }
+    for (int cutoff : TASK_FIB_CUTOFFS) {
+        for (int threads : thread_counts) {
+            ok = run_fib(threads, cutoff) && ok;
+        }
+    }
+    return ok ? 0 : 1;
+}
+
+// Termination mode: the standard 4P4C run with the shared consumed-items
+// counter vs the close/drain protocol, to show what the counter costs
+double run_termination(BenchQueue* queue, bool use_close, bool* ok) {
+    new (queue) BenchQueue();
+    std::atomic<uint64_t> total_consumed{0};
     constexpr uint64_t expected_total = NUM_PRODUCERS * OPS_PER_PRODUCER;
+    std::vector<std::thread> producers;
+    std::vector<std::thread> consumers;
+    std::vector<ThreadResult> producer_results(NUM_PRODUCERS);
+    std::vector<ThreadResult> consumer_results(NUM_CONSUMERS);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NUM_PRODUCERS; i++) {
+        producers.emplace_back(producer_thread<BenchQueue>, queue, i, OPS_PER_PRODUCER, &producer_results[i]);
+    }
+    for (int i = 0; i < NUM_CONSUMERS; i++) {
+        if (use_close) {
+            consumers.emplace_back(consumer_thread<BenchQueue>, queue, &consumer_results[i]);
+        } else {
+            consumers.emplace_back(counted_consumer_thread, queue, &total_consumed, expected_total,
+                                   &consumer_results[i]);
+        }
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    queue->close();
+    for (auto& t : consumers) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    uint64_t consumed = 0;
+    uint64_t sum = 0;
+    for (const auto& r : consumer_results) {
+        consumed += r.ops_completed;
+        sum += r.sum;
+    }
+    uint64_t expected_sum = expected_checksum(NUM_PRODUCERS);
+    *ok = (sum == expected_sum) && (consumed == expected_total);
+    double ops_per_sec = consumed / (elapsed_ms / 1000.0);
+
+    std::printf("mode=termination protocol=%s elapsed_ms=%.3f ops_per_sec=%.0f checksum=%lu expected=%lu status=%s\n",
+                use_close ? "close_drain" : "shared_counter", elapsed_ms, ops_per_sec, sum, expected_sum,
+                *ok ? "OK" : "MISMATCH");
+    queue->~BenchQueue();
+    return ops_per_sec;
+}
+
+int run_termination_comparison(BenchQueue* queue) {
+    bool counter_ok = false;
+    bool close_ok = false;
+    double counter = run_termination(queue, false, &counter_ok);
+    double drain = run_termination(queue, true, &close_ok);
+    std::printf("termination_change ops_per_sec_delta_pct=%.1f\n", (drain / counter - 1.0) * 100.0);
+    return (counter_ok && close_ok) ? 0 : 1;
+}
+
+// FAA mode: Vyukov CAS Queue vs SCQ fetch-and-add ring at rising thread
+// counts (producers == consumers), same harness and checksum as the default
+constexpr int FAA_THREAD_COUNTS[] = {1, 2, 4, 8, 16, 32, 64};
+
+using FaaQueue = ScqQueue<uint64_t, QUEUE_SIZE>;
+
+template <typename Q>
+bool run_faa_point(const char* name, Q* q, int threads) {
+    uint64_t expected_total = threads * OPS_PER_PRODUCER;
+    std::vector<std::thread> producers;
+    std::vector<std::thread> consumers;
+    std::vector<ThreadResult> producer_results(threads);
+    std::vector<ThreadResult> consumer_results(threads);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < threads; i++) {
+        producers.emplace_back(producer_thread<Q>, q, i, OPS_PER_PRODUCER, &producer_results[i]);
+    }
+    for (int i = 0; i < threads; i++) {
+        consumers.emplace_back(consumer_thread<Q>, q, &consumer_results[i]);
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    q->close();
+    for (auto& t : consumers) {
+        t.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    uint64_t consumed = 0;
+    uint64_t sum = 0;
+    for (const auto& r : consumer_results) {
+        consumed += r.ops_completed;
+        sum += r.sum;
+    }
+    uint64_t expected_sum = expected_checksum(threads);
+    bool ok = (sum == expected_sum) && (consumed == expected_total);
+
+    std::printf("mode=faa queue=%s producers=%d consumers=%d elapsed_ms=%.3f ops_per_sec=%.0f checksum=%lu expected=%lu status=%s\n",
+                name, threads, threads, elapsed_ms, consumed / (elapsed_ms / 1000.0),
+                sum, expected_sum, ok ? "OK" : "MISMATCH");
+    return ok;
+}
+
+int run_faa_comparison(BenchQueue* queue) {
+    void* mem = aligned_alloc(64, sizeof(FaaQueue));
+    if (!mem) {
+        std::fprintf(stderr, "Failed to allocate queue\n");
+        return 1;
+    }
+    // Oversubscribe up to 2x the hardware threads per side, at least 8
+    int max_threads = std::max(8, 2 * static_cast<int>(std::thread::hardware_concurrency()));
+    bool ok = true;
+
+    for (int threads : FAA_THREAD_COUNTS) {
+        if (threads > max_threads) break;
+        new (queue) BenchQueue();
+        ok = run_faa_point("cas", queue, threads) && ok;
+        queue->~BenchQueue();
+
+        FaaQueue* faa = new (mem) FaaQueue();
+        ok = run_faa_point("faa", faa, threads) && ok;
+        faa->~FaaQueue();
+    }
+    free(mem);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    // Aligned allocation for cache efficiency
+    void* mem = aligned_alloc(64, sizeof(BenchQueue));
+    if (!mem) {
+        std::fprintf(stderr, "Failed to allocate queue\n");
+        return 1;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "policy") == 0) {
+        free(mem);
+        return run_policy_sweep();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "latency") == 0) {
+        free(mem);
+        return run_latency_comparison();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "wait") == 0) {
+        int rc = run_wait_comparison(static_cast<BenchQueue*>(mem));
+        free(mem);
+        return rc;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "faa") == 0) {
+        int rc = run_faa_comparison(static_cast<BenchQueue*>(mem));
+        free(mem);
+        return rc;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "termination") == 0) {
+        int rc = run_termination_comparison(static_cast<BenchQueue*>(mem));
+        free(mem);
+        return rc;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "tasks") == 0) {
+        free(mem);
+        return run_task_comparison();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "sweep") == 0) {
+        uint64_t ops = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : SWEEP_OPS_PER_PRODUCER;
+        int rc = run_contention_sweep(static_cast<BenchQueue*>(mem), ops > 0 ? ops : SWEEP_OPS_PER_PRODUCER);
+        free(mem);
+        return rc;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "bulk") == 0) {
+        int rc = run_bulk_sweep(static_cast<BenchQueue*>(mem));
+        free(mem);
+        return rc;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "unbounded") == 0) {
+        int rc = run_unbounded_comparison(static_cast<BenchQueue*>(mem));
+        free(mem);
+        return rc;
+    }
+
+    BenchQueue* queue = new (mem) BenchQueue();
 
     std::vector<std::thread> producers;
     std::vector<std::thread> consumers;
@@ -161,16 +1334,17 @@ int main() {
 
     // Start all threads
     for (int i = 0; i < NUM_PRODUCERS; i++) {
-        producers.emplace_back(producer_thread, queue, i, &producer_results[i]);
+        producers.emplace_back(producer_thread<BenchQueue>, queue, i, OPS_PER_PRODUCER, &producer_results[i]);
     }
     for (int i = 0; i < NUM_CONSUMERS; i++) {
-        consumers.emplace_back(consumer_thread, queue, &g_total_consumed, expected_total, &consumer_results[i]);
+        consumers.emplace_back(consumer_thread<BenchQueue>, queue, &consumer_results[i]);
     }
 
-    // Wait for producers
+    // Wait for producers, then let consumers drain and exit
     for (auto& t : producers) {
         t.join();
     }
+    queue->close();
     // Wait for consumers
     for (auto& t : consumers) {
         t.join();
@@ -205,7 +1379,7 @@ int main() {
     std::printf("elapsed_ms=%.3f ops_per_sec=%.0f produced=%lu consumed=%lu checksum=%lu expected=%lu\n",
                 elapsed_ms, ops_per_sec, total_produced, total_consumed, total_sum, expected_sum);
 
-    queue->~Queue();
+    queue->~BenchQueue();
     free(mem);
 
     return (total_sum == expected_sum) ? 0 : 1;
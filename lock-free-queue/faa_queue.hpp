@@ -0,0 +1,206 @@
+#ifndef FAA_QUEUE_HPP
+#define FAA_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "queue.hpp"
+
+// Bounded fetch-and-add ring queue (SCQ, Nikolaev, DISC 2019)
+//
+// The Vyukov Queue claims a cell by CAS on enqueue_pos/dequeue_pos and
+// retries whenever another thread moved the counter first. SCQ claims a
+// position with one fetch-and-add on Tail/Head, which always succeeds, so
+// contended threads spread over distinct cells instead of retrying on one
+// counter. A CAS remains only on the claimed entry itself and practically
+// never fails.
+//
+// ScqRing is a ring of small integers (indices < Capacity) over 2*Capacity
+// entries. Each 64-bit entry packs, from high to low bits:
+//   cycle (Tail/Head >> log2(2*Capacity)) | IsSafe | index
+// and an index field of all ones is the empty marker (bottom). A dequeuer
+// that overtakes a slow enqueuer advances the entry's cycle (or clears
+// IsSafe) so the late enqueue is refused and retried elsewhere. The
+// Threshold counter bounds how many failing dequeues may run past Tail
+// before reporting empty, which keeps Head from overtaking Tail
+// indefinitely (livelock freedom).
+//
+// ScqQueue<T, Capacity> stores T in a data array. It uses two rings: fq
+// holds free indices and starts full, and aq holds allocated indices in
+// FIFO order. enqueue moves an index fq -> data write -> aq; dequeue moves
+// it aq -> data read -> fq. Full and empty both fall out of a ring's empty
+// check.
+
+template <size_t Capacity>
+class ScqRing {
+public:
+    static_assert(Capacity >= 8 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2 >= 8");
+    static constexpr uint64_t EMPTY = UINT64_MAX;
+
+    // Starts empty, or holding every index 0..Capacity-1
+    explicit ScqRing(bool full) {
+        for (size_t i = 0; i < RING; i++) {
+            entries_[i].store(UINT64_MAX, std::memory_order_relaxed);
+        }
+        head_.store(0, std::memory_order_relaxed);
+        if (full) {
+            for (size_t i = 0; i < Capacity; i++) {
+                entries_[remap(i, RING_BITS)].store(RING + i, std::memory_order_relaxed);  // Cycle 0, safe
+            }
+            tail_.store(Capacity, std::memory_order_relaxed);
+            threshold_.store(THRESHOLD, std::memory_order_relaxed);
+        } else {
+            tail_.store(0, std::memory_order_relaxed);
+            threshold_.store(-1, std::memory_order_relaxed);
+        }
+    }
+
+    void enqueue(uint64_t index) {
+        index ^= RING - 1;  // Stored XOR-ed so that tcycle ^ index sets IsSafe
+
+        for (;;) {
+            uint64_t tail = tail_.fetch_add(1, std::memory_order_acq_rel);
+            uint64_t tcycle = (tail << 1) | (2 * RING - 1);
+            std::atomic<uint64_t>& slot = entries_[remap(tail, RING_BITS)];
+            uint64_t entry = slot.load(std::memory_order_acquire);
+
+            for (;;) {
+                uint64_t ecycle = entry | (2 * RING - 1);
+                // Older cycle and empty: safe, or unsafe but no dequeuer is past us yet
+                bool usable = before(ecycle, tcycle) &&
+                              (entry == ecycle ||
+                               (entry == (ecycle ^ RING) &&
+                                !before(tail, head_.load(std::memory_order_acquire))));
+                if (!usable) break;
+                if (slot.compare_exchange_weak(entry, tcycle ^ index, std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+                    if (threshold_.load(std::memory_order_acquire) != THRESHOLD) {
+                        threshold_.store(THRESHOLD, std::memory_order_release);
+                    }
+                    return;
+                }
+            }
+        }
+    }
+
+    uint64_t dequeue() {
+        if (threshold_.load(std::memory_order_acquire) < 0) {
+            return EMPTY;
+        }
+
+        for (;;) {
+            uint64_t head = head_.fetch_add(1, std::memory_order_acq_rel);
+            uint64_t hcycle = (head << 1) | (2 * RING - 1);
+            std::atomic<uint64_t>& slot = entries_[remap(head, RING_BITS)];
+            int attempt = 0;
+            uint64_t entry = slot.load(std::memory_order_acquire);
+
+            for (;;) {
+                uint64_t ecycle = entry | (2 * RING - 1);
+                if (ecycle == hcycle) {
+                    slot.fetch_or(RING - 1, std::memory_order_acq_rel);  // Consume: index -> bottom
+                    return entry & (RING - 1);
+                }
+
+                uint64_t replacement;
+                if ((entry | RING) != ecycle) {
+                    // Holds an element of an older cycle: mark unsafe
+                    replacement = entry & ~RING;
+                    if (entry == replacement) break;
+                } else {
+                    // Empty: give a lagging enqueuer a moment, then move the cycle on
+                    if (++attempt <= SCQ_DEQUEUE_SPIN) {
+                        SPIN_PAUSE();
+                        entry = slot.load(std::memory_order_acquire);
+                        continue;
+                    }
+                    replacement = hcycle ^ ((~entry) & RING);
+                }
+                if (!before(ecycle, hcycle)) break;
+                if (slot.compare_exchange_weak(entry, replacement, std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+                    break;
+                }
+            }
+
+            uint64_t tail = tail_.load(std::memory_order_acquire);
+            if (!before(head + 1, tail)) {
+                catchup(tail, head + 1);
+                threshold_.fetch_sub(1, std::memory_order_acq_rel);
+                return EMPTY;
+            }
+            if (threshold_.fetch_sub(1, std::memory_order_acq_rel) <= 0) {
+                return EMPTY;
+            }
+        }
+    }
+
+    // Spreads consecutive positions over cache lines: rotates the low `bits`
+    // bits so neighbours land 8 entries (one 64-byte line) apart
+    static size_t remap(uint64_t pos, unsigned bits) {
+        uint64_t mask = (uint64_t{1} << bits) - 1;
+        return static_cast<size_t>(((pos & mask) >> (bits - 3)) | ((pos << 3) & mask));
+    }
+
+private:
+    static constexpr size_t RING = 2 * Capacity;
+    static constexpr unsigned RING_BITS = __builtin_ctzll(RING);
+    static constexpr int64_t THRESHOLD = 3 * static_cast<int64_t>(Capacity) - 1;
+    static constexpr int SCQ_DEQUEUE_SPIN = 64;
+
+    // Wrap-around safe a < b on the monotonically growing counters
+    static bool before(uint64_t a, uint64_t b) { return static_cast<int64_t>(a - b) < 0; }
+
+    // Pulls Tail up to Head after dequeuers ran past it
+    void catchup(uint64_t tail, uint64_t head) {
+        while (!tail_.compare_exchange_weak(tail, head, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            head = head_.load(std::memory_order_acquire);
+            tail = tail_.load(std::memory_order_acquire);
+            if (!before(tail, head)) break;
+        }
+    }
+
+    alignas(64) std::atomic<uint64_t> head_;
+    alignas(64) std::atomic<int64_t> threshold_;
+    alignas(64) std::atomic<uint64_t> tail_;
+    alignas(64) std::atomic<uint64_t> entries_[RING];
+};
+
+template <typename T, size_t Capacity>
+struct alignas(64) ScqQueue {
+    static_assert(std::is_trivially_copyable_v<T>, "ScqQueue copies payloads through a plain array");
+    static constexpr unsigned DATA_BITS = __builtin_ctzll(Capacity);
+
+    ScqRing<Capacity> aq{false};
+    ScqRing<Capacity> fq{true};
+    alignas(64) T data[Capacity];
+    alignas(64) std::atomic<bool> closed{false};
+
+    bool enqueue(const T& item) {
+        uint64_t idx = fq.dequeue();
+        if (idx == ScqRing<Capacity>::EMPTY) {
+            return false;  // Queue full
+        }
+        data[ScqRing<Capacity>::remap(idx, DATA_BITS)] = item;
+        aq.enqueue(idx);
+        return true;
+    }
+
+    bool dequeue(T& item) {
+        uint64_t idx = aq.dequeue();
+        if (idx == ScqRing<Capacity>::EMPTY) {
+            return false;  // Queue empty
+        }
+        item = data[ScqRing<Capacity>::remap(idx, DATA_BITS)];
+        fq.enqueue(idx);
+        return true;
+    }
+
+    // Same close/drain protocol as Queue
+    void close() { closed.store(true, std::memory_order_release); }
+    bool is_closed() const { return closed.load(std::memory_order_acquire); }
+};
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef QUEUE_HPP
+#define QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define SPIN_PAUSE() _mm_pause()
+#elif defined(__aarch64__)
+  #define SPIN_PAUSE() __asm__ __volatile__("isb")
+#else
+  #define SPIN_PAUSE() ((void)0)
+#endif
+
+// Bounded Queue (Dmitry Vyukov algorithm)
+//
+// Queue<T, Capacity, Policy> stores T in place (move-only and large types are
+// fine, try_emplace constructs directly in the cell). Capacity is a
+// compile-time power of two. Policy states how many threads may enqueue and
+// dequeue concurrently: a side with a single thread owns its position
+// counter and skips the CAS loop entirely.
+
+struct SPSC { static constexpr bool multi_producer = false; static constexpr bool multi_consumer = false; };
+struct MPSC { static constexpr bool multi_producer = true;  static constexpr bool multi_consumer = false; };
+struct MPMC { static constexpr bool multi_producer = true;  static constexpr bool multi_consumer = true;  };
+
+template <typename T>
+struct Cell {
+    std::atomic<uint64_t> sequence;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T* value() { return std::launder(reinterpret_cast<T*>(storage)); }
+};
+
+template <typename T, size_t Capacity, typename Policy = MPMC>
+struct alignas(64) Queue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+    static constexpr size_t MASK = Capacity - 1;
+
+    Cell<T> buffer[Capacity];
+    alignas(64) std::atomic<uint64_t> enqueue_pos;
+    alignas(64) std::atomic<uint64_t> dequeue_pos;
+    alignas(64) std::atomic<bool> closed;
+
+    Queue() {
+        for (size_t i = 0; i < Capacity; i++) {
+            buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos.store(0, std::memory_order_relaxed);
+        dequeue_pos.store(0, std::memory_order_relaxed);
+        closed.store(false, std::memory_order_relaxed);
+    }
+
+    ~Queue() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            for (; buffer[pos & MASK].sequence.load(std::memory_order_relaxed) == pos + 1; pos++) {
+                buffer[pos & MASK].value()->~T();
+            }
+        }
+    }
+
+    Queue(const Queue&) = delete;
+    Queue& operator=(const Queue&) = delete;
+
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        uint64_t pos;
+        if (claim_enqueue(pos, 1) == 0) {
+            return false;  // Queue full
+        }
+        Cell<T>* cell = &buffer[pos & MASK];
+        new (cell->storage) T(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool enqueue(const T& data) { return try_emplace(data); }
+    bool enqueue(T&& data) { return try_emplace(std::move(data)); }
+
+    bool dequeue(T& data) {
+        uint64_t pos;
+        if (claim_dequeue(pos, 1) == 0) {
+            return false;  // Queue empty
+        }
+        Cell<T>* cell = &buffer[pos & MASK];
+        T* value = cell->value();
+        data = std::move(*value);
+        value->~T();
+        cell->sequence.store(pos + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    // Close/drain protocol: once every producer has returned, one thread calls
+    // close(). A consumer that read is_closed() == true *before* a dequeue
+    // that then fails knows the queue is drained for good, so consumers need
+    // no shared consumed-items counter to decide when to stop.
+    void close() { closed.store(true, std::memory_order_release); }
+    bool is_closed() const { return closed.load(std::memory_order_acquire); }
+
+    // Bulk variants: scan ahead for a run of ready cells, claim the whole run
+    // with a single CAS on enqueue_pos/dequeue_pos, then fill or drain it.
+    // A ready cell cannot change state until the position counter moves past
+    // it, so a successful CAS from `pos` owns every scanned cell.
+    // Both return how many items were transferred (0 = full / empty).
+
+    size_t enqueue_bulk(const T* items, size_t n) {
+        uint64_t pos;
+        size_t count = claim_enqueue(pos, n);
+        for (size_t i = 0; i < count; i++) {
+            Cell<T>* cell = &buffer[(pos + i) & MASK];
+            new (cell->storage) T(items[i]);
+            cell->sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    size_t dequeue_bulk(T* items, size_t n) {
+        uint64_t pos;
+        size_t count = claim_dequeue(pos, n);
+        for (size_t i = 0; i < count; i++) {
+            Cell<T>* cell = &buffer[(pos + i) & MASK];
+            T* value = cell->value();
+            items[i] = std::move(*value);
+            value->~T();
+            cell->sequence.store(pos + i + Capacity, std::memory_order_release);
+        }
+        return count;
+    }
+
+private:
+    // Claims up to n consecutive cells whose sequence equals position + offset
+    // (free cells for producers: offset 0, full cells for consumers: offset 1).
+    // Returns the number claimed; `pos` receives the first position.
+    template <bool MultiThreaded>
+    size_t claim(std::atomic<uint64_t>& position, uint64_t offset, uint64_t& pos, size_t n) {
+        n = n < Capacity ? n : Capacity;
+        pos = position.load(std::memory_order_relaxed);
+
+        for (;;) {
+            size_t count = 0;
+            int64_t diff = 0;
+            while (count < n) {
+                uint64_t seq = buffer[(pos + count) & MASK].sequence.load(std::memory_order_acquire);
+                diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos + count + offset);
+                if (diff != 0) break;
+                count++;
+            }
+
+            if (count > 0) {
+                if constexpr (!MultiThreaded) {
+                    // Sole owner of this side: nobody else moves the counter
+                    position.store(pos + count, std::memory_order_relaxed);
+                    return count;
+                } else if (position.compare_exchange_weak(pos, pos + count,
+                               std::memory_order_relaxed, std::memory_order_relaxed)) {
+                    return count;
+                }
+            } else if (diff < 0 || !MultiThreaded) {
+                return 0;
+            } else {
+                pos = position.load(std::memory_order_relaxed);
+            }
+            SPIN_PAUSE();
+        }
+    }
+
+    size_t claim_enqueue(uint64_t& pos, size_t n) {
+        return claim<Policy::multi_producer>(enqueue_pos, 0, pos, n);
+    }
+
+    size_t claim_dequeue(uint64_t& pos, size_t n) {
+        return claim<Policy::multi_consumer>(dequeue_pos, 1, pos, n);
+    }
+};
+
+#endif
@@ -0,0 +1,319 @@
+#ifndef SEGMENTED_QUEUE_HPP
+#define SEGMENTED_QUEUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Unbounded MPMC Queue built from linked fixed-size segments
+//
+// Each segment is an array of cells claimed with fetch-and-add on its own
+// enqueue/dequeue index (no CAS retry loop on a shared counter). When a
+// segment's indices run past SEGMENT_SIZE a new segment is linked behind it.
+// Drained segments are unlinked from the head and reclaimed with epoch-based
+// reclamation (EBR), then recycled through a SegmentPool, so memory follows
+// the live backlog instead of a worst-case preallocation.
+//
+// Payload restriction: 0 and UINT64_MAX are reserved as cell markers.
+
+constexpr size_t SEGMENT_SIZE = 1024;
+constexpr size_t MAX_EBR_THREADS = 256;
+constexpr size_t EBR_RECLAIM_BATCH = 16;   // Retired segments before a reclaim attempt
+constexpr size_t SEGMENT_POOL_MAX = 16;    // Free segments kept for reuse
+
+constexpr uint64_t CELL_EMPTY = 0;
+constexpr uint64_t CELL_TAKEN = UINT64_MAX;
+
+struct alignas(64) Segment {
+    alignas(64) std::atomic<uint64_t> enqueue_idx;
+    alignas(64) std::atomic<uint64_t> dequeue_idx;
+    alignas(64) std::atomic<Segment*> next;
+    uint64_t retire_epoch;
+    std::atomic<uint64_t> items[SEGMENT_SIZE];
+
+    void reset() {
+        enqueue_idx.store(0, std::memory_order_relaxed);
+        dequeue_idx.store(0, std::memory_order_relaxed);
+        next.store(nullptr, std::memory_order_relaxed);
+        for (size_t i = 0; i < SEGMENT_SIZE; i++) {
+            items[i].store(CELL_EMPTY, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Recycles segments; only touched once per SEGMENT_SIZE operations, so a
+// mutex is cheaper than it looks. Tracks the memory footprint.
+class SegmentPool {
+public:
+    ~SegmentPool() {
+        for (Segment* seg : free_) {
+            free_segment(seg);
+        }
+    }
+
+    Segment* acquire() {
+        Segment* seg = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_.empty()) {
+                seg = free_.back();
+                free_.pop_back();
+            }
+        }
+        if (!seg) {
+            void* mem = aligned_alloc(64, sizeof(Segment));
+            if (!mem) {
+                std::fprintf(stderr, "Failed to allocate segment\n");
+                std::abort();
+            }
+            seg = new (mem) Segment();
+            allocated_.fetch_add(1, std::memory_order_relaxed);
+        }
+        seg->reset();
+        return seg;
+    }
+
+    void release(Segment* seg) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (free_.size() < SEGMENT_POOL_MAX) {
+                free_.push_back(seg);
+                return;
+            }
+        }
+        free_segment(seg);
+    }
+
+    // Segments currently held in memory (live in the queue or pooled)
+    uint64_t allocated() const { return allocated_.load(std::memory_order_relaxed); }
+    uint64_t footprint_bytes() const { return allocated() * sizeof(Segment); }
+
+private:
+    void free_segment(Segment* seg) {
+        seg->~Segment();
+        free(seg);
+        allocated_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::mutex mutex_;
+    std::vector<Segment*> free_;
+    std::atomic<uint64_t> allocated_{0};
+};
+
+// Epoch-based reclamation. A thread announces the global epoch while it holds
+// segment pointers; a segment retired at epoch e is only recycled once the
+// global epoch reaches e + 2, i.e. every thread has left the epochs in which
+// it could still have seen the segment.
+class EpochDomain {
+public:
+    static constexpr uint64_t IDLE = UINT64_MAX;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{IDLE};
+        std::atomic<bool> in_use{false};
+    };
+
+    int register_thread() {
+        for (size_t i = 0; i < MAX_EBR_THREADS; i++) {
+            bool expected = false;
+            if (slots_[i].in_use.compare_exchange_strong(expected, true)) {
+                size_t hw = high_water_.load(std::memory_order_relaxed);
+                while (hw < i + 1 && !high_water_.compare_exchange_weak(hw, i + 1)) {}
+                return static_cast<int>(i);
+            }
+        }
+        std::fprintf(stderr, "Too many threads for EpochDomain\n");
+        std::abort();
+    }
+
+    void unregister_thread(int slot) {
+        slots_[slot].epoch.store(IDLE, std::memory_order_release);
+        slots_[slot].in_use.store(false, std::memory_order_release);
+    }
+
+    void enter(int slot) {
+        slots_[slot].epoch.store(global_epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void exit(int slot) {
+        slots_[slot].epoch.store(IDLE, std::memory_order_release);
+    }
+
+    uint64_t epoch() const { return global_epoch_.load(std::memory_order_acquire); }
+
+    // Advances the global epoch if every active thread has observed it
+    void try_advance() {
+        uint64_t e = global_epoch_.load(std::memory_order_acquire);
+        size_t hw = high_water_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < hw; i++) {
+            uint64_t local = slots_[i].epoch.load(std::memory_order_acquire);
+            if (local != IDLE && local != e) return;
+        }
+        global_epoch_.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel);
+    }
+
+private:
+    alignas(64) std::atomic<uint64_t> global_epoch_{0};
+    alignas(64) std::atomic<size_t> high_water_{0};
+    Slot slots_[MAX_EBR_THREADS];
+};
+
+class SegmentedQueue {
+public:
+    // Per-thread state: EBR slot and the segments this thread retired
+    class Handle {
+    public:
+        explicit Handle(SegmentedQueue* q) : q_(q), slot_(q->ebr_.register_thread()) {}
+        // Hands the retired list to the queue and reclaims what it can: with
+        // this thread gone, the epoch may now advance past its segments
+        ~Handle() {
+            q_->ebr_.unregister_thread(slot_);
+            std::lock_guard<std::mutex> lock(q_->orphan_mutex_);
+            q_->orphans_.insert(q_->orphans_.end(), retired_.begin(), retired_.end());
+            q_->reclaim(q_->orphans_, 2);
+        }
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+    private:
+        friend class SegmentedQueue;
+        SegmentedQueue* q_;
+        int slot_;
+        std::vector<Segment*> retired_;
+    };
+
+    SegmentedQueue() {
+        Segment* seg = pool_.acquire();
+        head_.store(seg, std::memory_order_relaxed);
+        tail_.store(seg, std::memory_order_relaxed);
+    }
+
+    // All handles must be destroyed first
+    ~SegmentedQueue() {
+        Segment* seg = head_.load(std::memory_order_relaxed);
+        while (seg) {
+            Segment* next = seg->next.load(std::memory_order_relaxed);
+            pool_.release(seg);
+            seg = next;
+        }
+        for (Segment* s : orphans_) {
+            pool_.release(s);
+        }
+    }
+
+    void enqueue(Handle& h, uint64_t data) {
+        ebr_.enter(h.slot_);
+        for (;;) {
+            Segment* tail = tail_.load(std::memory_order_acquire);
+            uint64_t idx = tail->enqueue_idx.fetch_add(1, std::memory_order_relaxed);
+
+            if (idx < SEGMENT_SIZE) {
+                uint64_t expected = CELL_EMPTY;
+                if (tail->items[idx].compare_exchange_strong(expected, data,
+                        std::memory_order_release, std::memory_order_relaxed)) {
+                    break;
+                }
+                continue;  // A consumer gave up on this cell first: take another
+            }
+
+            // Segment exhausted: link a new one (or help whoever already did)
+            if (tail != tail_.load(std::memory_order_acquire)) continue;
+            Segment* next = tail->next.load(std::memory_order_acquire);
+            if (next) {
+                tail_.compare_exchange_strong(tail, next);
+                continue;
+            }
+            Segment* seg = pool_.acquire();
+            seg->enqueue_idx.store(1, std::memory_order_relaxed);
+            seg->items[0].store(data, std::memory_order_relaxed);
+            if (tail->next.compare_exchange_strong(next, seg, std::memory_order_release)) {
+                tail_.compare_exchange_strong(tail, seg);
+                break;
+            }
+            pool_.release(seg);  // Never published, safe to recycle at once
+        }
+        ebr_.exit(h.slot_);
+    }
+
+    bool dequeue(Handle& h, uint64_t& data) {
+        ebr_.enter(h.slot_);
+        bool found = false;
+        for (;;) {
+            Segment* head = head_.load(std::memory_order_acquire);
+            if (head->dequeue_idx.load(std::memory_order_relaxed) >= head->enqueue_idx.load(std::memory_order_relaxed) &&
+                head->next.load(std::memory_order_acquire) == nullptr) {
+                break;  // Queue empty
+            }
+
+            uint64_t idx = head->dequeue_idx.fetch_add(1, std::memory_order_relaxed);
+            if (idx < SEGMENT_SIZE) {
+                uint64_t item = head->items[idx].exchange(CELL_TAKEN, std::memory_order_acquire);
+                if (item == CELL_EMPTY) continue;  // Producer not there yet; it will retry elsewhere
+                data = item;
+                found = true;
+                break;
+            }
+
+            // Segment drained: move head (never leaving tail behind it) and retire it
+            Segment* next = head->next.load(std::memory_order_acquire);
+            if (!next) break;
+            Segment* expected_tail = head;
+            tail_.compare_exchange_strong(expected_tail, next);
+            if (head_.compare_exchange_strong(head, next)) {
+                retire(h, head);
+            }
+        }
+        ebr_.exit(h.slot_);
+        return found;
+    }
+
+    // Same close/drain protocol as Queue: read is_closed() before a dequeue;
+    // if that dequeue then fails, every item has been consumed
+    void close() { closed_.store(true, std::memory_order_release); }
+    bool is_closed() const { return closed_.load(std::memory_order_acquire); }
+
+    uint64_t footprint_bytes() const { return pool_.footprint_bytes(); }
+
+private:
+    void retire(Handle& h, Segment* seg) {
+        seg->retire_epoch = ebr_.epoch();
+        h.retired_.push_back(seg);
+        if (h.retired_.size() < EBR_RECLAIM_BATCH) return;
+
+        reclaim(h.retired_, 1);
+        // Segments left by exited threads, if nobody else is on them
+        std::unique_lock<std::mutex> lock(orphan_mutex_, std::try_to_lock);
+        if (lock.owns_lock() && !orphans_.empty()) reclaim(orphans_, 0);
+    }
+
+    // Recycles the segments in `list` retired at least two epochs ago, after
+    // trying to advance the global epoch `advances` times
+    void reclaim(std::vector<Segment*>& list, int advances) {
+        for (int i = 0; i < advances; i++) ebr_.try_advance();
+        uint64_t now = ebr_.epoch();
+        size_t kept = 0;
+        for (Segment* s : list) {
+            if (s->retire_epoch + 2 <= now) {
+                pool_.release(s);
+            } else {
+                list[kept++] = s;
+            }
+        }
+        list.resize(kept);
+    }
+
+    alignas(64) std::atomic<Segment*> head_;
+    alignas(64) std::atomic<Segment*> tail_;
+    alignas(64) std::atomic<bool> closed_{false};
+    SegmentPool pool_;
+    EpochDomain ebr_;
+    std::mutex orphan_mutex_;
+    std::vector<Segment*> orphans_;
+};
+
+#endif
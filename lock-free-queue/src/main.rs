@@ -24,6 +24,7 @@ struct Queue {
     buffer: [Cell; QUEUE_SIZE],
     enqueue_pos: AlignedAtomic,
     dequeue_pos: AlignedAtomic,
+    closed: AlignedAtomic,
 }
 
 impl Queue {
@@ -42,10 +43,22 @@ impl Queue {
             }
             std::ptr::write(&mut (*ptr).enqueue_pos, AlignedAtomic(AtomicU64::new(0)));
             std::ptr::write(&mut (*ptr).dequeue_pos, AlignedAtomic(AtomicU64::new(0)));
+            std::ptr::write(&mut (*ptr).closed, AlignedAtomic(AtomicU64::new(0)));
             Box::from_raw(ptr)
         }
     }
 
+    // Close/drain protocol: called once every producer has returned. A consumer
+    // that saw the queue closed before a failed dequeue knows it is drained.
+    fn close(&self) {
+        self.closed.0.store(1, Ordering::Release);
+    }
+
+    #[inline(always)]
+    fn is_closed(&self) -> bool {
+        self.closed.0.load(Ordering::Acquire) != 0
+    }
+
     #[inline(always)]
     fn enqueue(&self, data: u64) -> bool {
         let mut pos = self.enqueue_pos.0.load(Ordering::Relaxed);
@@ -125,8 +138,6 @@ const OPS_PER_PRODUCER: u64 = 1000000;
 
 fn main() {
     let queue: std::sync::Arc<Queue> = std::sync::Arc::from(Queue::new());
-    let total_consumed = std::sync::Arc::new(AtomicU64::new(0));
-    let expected_total = NUM_PRODUCERS as u64 * OPS_PER_PRODUCER;
 
     let start = Instant::now();
 
@@ -153,17 +164,18 @@ fn main() {
     let mut consumer_handles = Vec::with_capacity(NUM_CONSUMERS);
     for _ in 0..NUM_CONSUMERS {
         let q = queue.clone();
-        let tc = total_consumed.clone();
         consumer_handles.push(thread::spawn(move || {
             let mut sum: u64 = 0;
             let mut ops: u64 = 0;
 
-            while tc.load(Ordering::Relaxed) < expected_total {
+            loop {
+                let closed = q.is_closed(); // Must be read before the dequeue attempt
                 let mut value = 0;
                 if q.dequeue(&mut value) {
                     sum += value;
                     ops += 1;
-                    tc.fetch_add(1, Ordering::Relaxed);
+                } else if closed {
+                    break;
                 } else {
                     thread::yield_now();
                 }
@@ -173,11 +185,12 @@ fn main() {
         }));
     }
 
-    // Wait for producers
+    // Wait for producers, then let consumers drain and exit
     let mut total_produced: u64 = 0;
     for handle in producer_handles {
         total_produced += handle.join().unwrap();
     }
+    queue.close();
 
     // Wait for consumers
     let mut total_sum: u64 = 0;
@@ -0,0 +1,110 @@
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+// CPU topology from /sys/devices/system/cpu/cpuN/topology, restricted to the
+// CPUs this process may run on (sched_getaffinity, so container cpusets are
+// respected). Used to place producers and consumers for the sweep mode.
+
+struct CpuInfo {
+    int cpu;
+    int core;     // core_id, unique within a package
+    int package;  // physical_package_id (socket)
+};
+
+inline int read_sysfs_int(int cpu, const char* file, int fallback) {
+    char path[128];
+    std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, file);
+    FILE* f = std::fopen(path, "r");
+    if (!f) return fallback;
+    int value = fallback;
+    if (std::fscanf(f, "%d", &value) != 1) value = fallback;
+    std::fclose(f);
+    return value;
+}
+
+inline std::vector<CpuInfo> read_topology() {
+    std::vector<CpuInfo> cpus;
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return cpus;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed)) continue;
+        // Missing topology files: treat every CPU as its own core on socket 0
+        cpus.push_back({cpu, read_sysfs_int(cpu, "core_id", cpu), read_sysfs_int(cpu, "physical_package_id", 0)});
+    }
+    return cpus;
+}
+
+inline std::vector<int> packages_of(const std::vector<CpuInfo>& cpus) {
+    std::vector<int> packages;
+    for (const auto& c : cpus) {
+        if (std::find(packages.begin(), packages.end(), c.package) == packages.end()) {
+            packages.push_back(c.package);
+        }
+    }
+    std::sort(packages.begin(), packages.end());
+    return packages;
+}
+
+inline bool has_smt(const std::vector<CpuInfo>& cpus) {
+    for (size_t i = 0; i < cpus.size(); i++) {
+        for (size_t j = i + 1; j < cpus.size(); j++) {
+            if (cpus[i].package == cpus[j].package && cpus[i].core == cpus[j].core) return true;
+        }
+    }
+    return false;
+}
+
+// CPUs of one package, or of all packages when package < 0.
+// siblings_adjacent: SMT siblings of a core follow each other (fill cores
+// thread by thread); otherwise one thread per core comes first (spread).
+inline std::vector<int> cpu_order(const std::vector<CpuInfo>& cpus, int package, bool siblings_adjacent) {
+    std::vector<CpuInfo> picked;
+    for (const auto& c : cpus) {
+        if (package < 0 || c.package == package) picked.push_back(c);
+    }
+    // Rank of each CPU among the siblings of its core
+    std::vector<int> rank(picked.size(), 0);
+    for (size_t i = 0; i < picked.size(); i++) {
+        for (size_t j = 0; j < i; j++) {
+            if (picked[j].package == picked[i].package && picked[j].core == picked[i].core) rank[i]++;
+        }
+    }
+    std::vector<size_t> idx(picked.size());
+    for (size_t i = 0; i < idx.size(); i++) idx[i] = i;
+    std::sort(idx.begin(), idx.end(), [&](size_t a, size_t b) {
+        const CpuInfo& x = picked[a];
+        const CpuInfo& y = picked[b];
+        if (siblings_adjacent) {
+            if (x.package != y.package) return x.package < y.package;
+            if (x.core != y.core) return x.core < y.core;
+            return rank[a] < rank[b];
+        }
+        if (rank[a] != rank[b]) return rank[a] < rank[b];
+        if (x.package != y.package) return x.package < y.package;
+        return x.core < y.core;
+    });
+    std::vector<int> order;
+    for (size_t i : idx) order.push_back(picked[i].cpu);
+    return order;
+}
+
+// Pins the calling thread; cpu < 0 leaves it unpinned
+inline bool pin_current_thread(int cpu) {
+    if (cpu < 0) return true;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+#endif
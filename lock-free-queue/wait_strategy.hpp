@@ -0,0 +1,144 @@
+#ifndef WAIT_STRATEGY_HPP
+#define WAIT_STRATEGY_HPP
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#include "queue.hpp"
+
+#if defined(__linux__)
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+// Pluggable wait strategies for a full / empty Queue
+//
+// A strategy instance guards one condition (e.g. "not empty"). Waiters call
+// wait_until(ready), where ready() retries the queue operation and returns
+// true once it succeeded (or there is nothing left to wait for). The other
+// side calls notify_one() after every successful operation, and notify_all()
+// at shutdown.
+
+constexpr int WAIT_SPIN_LIMIT = 128;  // Pause iterations before yielding / parking
+
+// Busy-polls with a pause hint and never gives up the core
+struct SpinWait {
+    static constexpr const char* name = "spin";
+
+    template <typename Ready>
+    void wait_until(Ready&& ready) {
+        while (!ready()) {
+            SPIN_PAUSE();
+        }
+    }
+
+    void notify_one() {}
+    void notify_all() {}
+};
+
+// Spins briefly, then hands the core back to the scheduler between retries
+struct SpinYieldWait {
+    static constexpr const char* name = "spin_yield";
+
+    template <typename Ready>
+    void wait_until(Ready&& ready) {
+        for (int i = 0; i < WAIT_SPIN_LIMIT; i++) {
+            if (ready()) return;
+            SPIN_PAUSE();
+        }
+        while (!ready()) {
+            std::this_thread::yield();
+        }
+    }
+
+    void notify_one() {}
+    void notify_all() {}
+};
+
+// Eventcount: waiters announce themselves, re-check the condition, then
+// sleep on a futex until the epoch changes. Waiter count and epoch share one
+// 64-bit word (epoch << 32 | waiters), so prepare_wait reads the epoch in the
+// same atomic step that registers the waiter. notify() with nobody waiting is
+// a fence and a load, no syscall and no shared write.
+class EventCount {
+public:
+    uint32_t prepare_wait() {
+        uint64_t prev = val_.fetch_add(1, std::memory_order_seq_cst);
+        return static_cast<uint32_t>(prev >> EPOCH_SHIFT);
+    }
+
+    void cancel_wait() {
+        val_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    void commit_wait(uint32_t key) {
+        while (static_cast<uint32_t>(val_.load(std::memory_order_acquire) >> EPOCH_SHIFT) == key) {
+            futex_wait(key);
+        }
+        val_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    void notify(int count) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ((val_.load(std::memory_order_relaxed) & WAITER_MASK) == 0) {
+            return;
+        }
+        val_.fetch_add(uint64_t{1} << EPOCH_SHIFT, std::memory_order_acq_rel);
+        futex_wake(count);
+    }
+
+private:
+    static constexpr int EPOCH_SHIFT = 32;
+    static constexpr uint64_t WAITER_MASK = 0xffffffffu;
+
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "epoch must be the high 32-bit half");
+
+    uint32_t* epoch_word() {
+        return reinterpret_cast<uint32_t*>(&val_) + 1;
+    }
+
+#if defined(__linux__)
+    void futex_wait(uint32_t key) {
+        syscall(SYS_futex, epoch_word(), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+    }
+    void futex_wake(int count) {
+        syscall(SYS_futex, epoch_word(), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+    }
+#else
+    void futex_wait(uint32_t) { std::this_thread::yield(); }
+    void futex_wake(int) {}
+#endif
+
+    alignas(64) std::atomic<uint64_t> val_{0};
+};
+
+// Spins briefly, then parks on an EventCount until notified
+struct SpinFutexWait {
+    static constexpr const char* name = "spin_futex";
+
+    template <typename Ready>
+    void wait_until(Ready&& ready) {
+        for (int i = 0; i < WAIT_SPIN_LIMIT; i++) {
+            if (ready()) return;
+            SPIN_PAUSE();
+        }
+        for (;;) {
+            uint32_t key = ec.prepare_wait();
+            if (ready()) {
+                ec.cancel_wait();
+                return;
+            }
+            ec.commit_wait(key);
+        }
+    }
+
+    void notify_one() { ec.notify(1); }
+    void notify_all() { ec.notify(INT_MAX); }
+
+    EventCount ec;
+};
+
+#endif
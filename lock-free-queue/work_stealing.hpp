@@ -0,0 +1,270 @@
+#ifndef WORK_STEALING_HPP
+#define WORK_STEALING_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "queue.hpp"
+
+// Chase-Lev work-stealing deque (C11 formulation of Le, Pop, Cohen and
+// Zappa Nardelli, PPoPP 2013)
+//
+// The owner pushes and pops at the bottom without any atomic RMW except
+// when racing a thief for the last element; thieves take from the top with
+// one CAS. The circular array grows on demand. Old arrays may still be read
+// by a thief that loaded the pointer before the swap, so they are retired
+// into a list and only freed with the deque.
+
+template <typename T>
+class ChaseLevDeque {
+public:
+    explicit ChaseLevDeque(int64_t capacity = 256) {
+        arrays_.emplace_back(new Array(capacity));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    // Owner only
+    void push(T item) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Array* a = array_.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            a = grow(a, t, b);
+        }
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only: LIFO end
+    bool pop(T& out) {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);  // Empty
+            return false;
+        }
+        out = a->get(b);
+        if (t == b) {
+            // Last element: race the thieves for it
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread: FIFO end. False when empty or when another thief won.
+    bool steal(T& out) {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        Array* a = array_.load(std::memory_order_acquire);
+        T item = a->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+        out = item;
+        return true;
+    }
+
+private:
+    struct Array {
+        int64_t capacity;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Array(int64_t cap) : capacity(cap), slots(new std::atomic<T>[cap]) {}
+        T get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t i, T v) { slots[i & (capacity - 1)].store(v, std::memory_order_relaxed); }
+    };
+
+    Array* grow(Array* old, int64_t t, int64_t b) {
+        arrays_.emplace_back(new Array(old->capacity * 2));
+        Array* a = arrays_.back().get();
+        for (int64_t i = t; i < b; i++) {
+            a->put(i, old->get(i));
+        }
+        array_.store(a, std::memory_order_release);
+        return a;
+    }
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) std::atomic<Array*> array_;
+    std::vector<std::unique_ptr<Array>> arrays_;  // Owner only: current + retired
+};
+
+// Fork/join tasks
+//
+// Tasks live in the spawning frame (no allocation per task): spawn() only
+// publishes a pointer, and wait() does not return until every task of the
+// group has finished, so the frame outlives them.
+
+struct Task {
+    virtual ~Task() = default;
+    virtual void execute() = 0;
+    std::atomic<int>* pending = nullptr;
+};
+
+template <typename F>
+struct FnTask final : Task {
+    F fn;
+    explicit FnTask(F f) : fn(std::move(f)) {}
+    void execute() override { fn(); }
+};
+
+template <typename F>
+FnTask<F> make_task(F fn) {
+    return FnTask<F>(std::move(fn));
+}
+
+struct TaskGroup {
+    std::atomic<int> pending{0};
+};
+
+inline void run_task(Task* task) {
+    std::atomic<int>* pending = task->pending;  // The task may be gone once pending drops
+    task->execute();
+    pending->fetch_sub(1, std::memory_order_release);
+}
+
+// Fork/join scheduler: one Chase-Lev deque per worker. Workers pop their own
+// deque LIFO (depth-first, cache-warm) and steal FIFO from a random victim
+// (the oldest, usually largest, task) when it runs dry. wait() helps instead
+// of blocking. The thread calling run() acts as worker 0.
+class WorkStealingScheduler {
+public:
+    static constexpr const char* name = "work_stealing";
+
+    explicit WorkStealingScheduler(int num_threads) {
+        for (int i = 0; i < num_threads; i++) {
+            workers_.emplace_back(new Worker(i));
+        }
+        for (int i = 1; i < num_threads; i++) {
+            threads_.emplace_back(&WorkStealingScheduler::worker_loop, this, i);
+        }
+    }
+
+    ~WorkStealingScheduler() {
+        stop_.store(true, std::memory_order_relaxed);
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+    template <typename F>
+    void run(F&& root) {
+        current_ = workers_[0].get();
+        root();
+        current_ = nullptr;
+    }
+
+    // Only from inside run() or a task
+    void spawn(TaskGroup& group, Task& task) {
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+        task.pending = &group.pending;
+        current_->deque.push(&task);
+    }
+
+    void wait(TaskGroup& group) {
+        Worker& self = *current_;
+        while (group.pending.load(std::memory_order_acquire) > 0) {
+            Task* task;
+            if (self.deque.pop(task) || try_steal(self, task)) {
+                run_task(task);
+            } else {
+                SPIN_PAUSE();
+            }
+        }
+    }
+
+    // Recursive binary split: each level spawns the right half and recurses
+    // into the left, so idle workers steal large ranges
+    template <typename Body>
+    void parallel_for(int64_t begin, int64_t end, int64_t grain, const Body& body) {
+        if (end - begin <= grain) {
+            for (int64_t i = begin; i < end; i++) body(i);
+            return;
+        }
+        int64_t mid = begin + (end - begin) / 2;
+        TaskGroup group;
+        auto right = make_task([&] { parallel_for(mid, end, grain, body); });
+        spawn(group, right);
+        parallel_for(begin, mid, grain, body);
+        wait(group);
+    }
+
+    uint64_t steals() const {
+        uint64_t total = 0;
+        for (const auto& w : workers_) total += w->steals.load(std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    struct alignas(64) Worker {
+        explicit Worker(int i) : index(i), rng(0x9E3779B97F4A7C15ull * (i + 1)) {}
+        int index;
+        uint64_t rng;
+        std::atomic<uint64_t> steals{0};
+        ChaseLevDeque<Task*> deque;
+    };
+
+    bool try_steal(Worker& self, Task*& task) {
+        size_t n = workers_.size();
+        if (n < 2) return false;
+        for (size_t attempt = 0; attempt < n; attempt++) {
+            // xorshift64 victim choice
+            self.rng ^= self.rng << 13;
+            self.rng ^= self.rng >> 7;
+            self.rng ^= self.rng << 17;
+            Worker& victim = *workers_[self.rng % n];
+            if (&victim != &self && victim.deque.steal(task)) {
+                self.steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker_loop(int index) {
+        Worker& self = *workers_[index];
+        current_ = &self;
+        int idle = 0;
+        while (!stop_.load(std::memory_order_relaxed)) {
+            Task* task;
+            if (self.deque.pop(task) || try_steal(self, task)) {
+                run_task(task);
+                idle = 0;
+            } else if (++idle < 64) {
+                SPIN_PAUSE();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    inline static thread_local Worker* current_ = nullptr;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stop_{false};
+};
+
+#endif
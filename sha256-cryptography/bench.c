@@ -15,6 +15,9 @@ int main() {
     const int num_hashes = 1000000;
     const uint8_t *base_message = (const uint8_t *)"Computational Benchmarks - Language Performance Lab";
     size_t base_len = strlen((const char *)base_message);
+
+    /* Software-only comparison with the C++ and Rust versions */
+    sha256_set_impl(SHA256_IMPL_PORTABLE);
     
     double start = now_ms();
     uint8_t final_hash[32];
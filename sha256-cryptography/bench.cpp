@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <chrono>
@@ -5,9 +6,13 @@
 #include <iomanip>
 #include "sha256.h"
 
-int main() {
-    const int num_hashes = 1000000;
-    const uint8_t *base_message = (const uint8_t *)"Computational Benchmarks - Language Performance Lab";
+static const int num_hashes = 1000000;
+static const uint8_t *base_message = (const uint8_t *)"Computational Benchmarks - Language Performance Lab";
+
+// Standard benchmark: matches the C and Rust versions, so it stays on the
+// portable transform whatever the CPU offers
+static int run_standard() {
+    sha256_set_impl(SHA256_IMPL_PORTABLE);
     size_t base_len = std::strlen((const char *)base_message);
     
     auto start = std::chrono::high_resolution_clock::now();
@@ -38,3 +43,179 @@ int main() {
 
     return 0;
 }
+
+// ---------------------------------------------------------------------------
+// Extended modes. Each hashes the same base_message || big-endian nonce
+// messages for nonces 0..num_hashes-1 and prints one line per variant; the
+// checksum is the last message's hash, so it must match the standard run.
+
+static void hex(char out[65], const uint8_t hash[32]) {
+    for (int i = 0; i < 32; i++) std::snprintf(out + 2 * i, 3, "%02x", hash[i]);
+}
+
+static void make_message(uint8_t *msg, size_t base_len, uint32_t nonce) {
+    std::memcpy(msg, base_message, base_len);
+    msg[base_len] = (nonce >> 24) & 0xFF;
+    msg[base_len + 1] = (nonce >> 16) & 0xFF;
+    msg[base_len + 2] = (nonce >> 8) & 0xFF;
+    msg[base_len + 3] = nonce & 0xFF;
+}
+
+// mismatched: digests that differ from the scalar path, when every digest was checked
+static bool report(const char *mode, int lanes, double elapsed_ms, const uint8_t hash[32], const char *expected,
+                   int64_t mismatched = -1) {
+    char digest[65];
+    hex(digest, hash);
+    bool ok = std::strcmp(digest, expected) == 0 && mismatched <= 0;
+    double hashes_per_sec = (double)num_hashes / (elapsed_ms / 1000.0);
+    std::printf("mode=%s lanes=%d elapsed_ms=%.3f hashes_per_sec=%.0f mh_per_sec=%.2f checksum=%s ", mode, lanes,
+                elapsed_ms, hashes_per_sec, hashes_per_sec / 1e6, digest);
+    if (mismatched >= 0) std::printf("mismatched=%lld ", (long long)mismatched);
+    std::printf("status=%s\n", ok ? "OK" : "MISMATCH");
+    std::fflush(stdout);
+    return ok;
+}
+
+// Scalar init/update/final per nonce, as in the standard run; returns the
+// elapsed time and leaves the last hash in `hash`. With `all`, every digest
+// is kept there, 32 bytes per nonce.
+static double time_scalar(uint8_t hash[32], uint8_t *all = nullptr) {
+    size_t base_len = std::strlen((const char *)base_message);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t nonce = 0; nonce < (uint32_t)num_hashes; nonce++) {
+        uint8_t msg[64];
+        make_message(msg, base_len, nonce);
+        SHA256_CTX ctx;
+        sha256_init(&ctx);
+        sha256_update(&ctx, msg, base_len + 4);
+        sha256_final(&ctx, all ? all + (size_t)nonce * 32 : hash);
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (all) std::memcpy(hash, all + (size_t)(num_hashes - 1) * 32, 32);
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Multi mode: sha256_multi over 4, 8 and 16 lanes vs the portable scalar path.
+// Every lane writes its digest straight into a per-nonce array, and each
+// digest is compared with the scalar one for the same nonce after the run.
+static constexpr int MULTI_LANES[] = {4, 8, 16};
+
+static int run_multi_comparison() {
+    sha256_set_impl(SHA256_IMPL_PORTABLE);
+    size_t base_len = std::strlen((const char *)base_message);
+    uint8_t hash[32];
+    char expected[65];
+    std::vector<uint8_t> reference((size_t)num_hashes * 32);
+    double scalar_ms = time_scalar(hash, reference.data());
+    hex(expected, hash);
+    bool ok = report("scalar", 1, scalar_ms, hash, expected);
+
+    std::vector<uint8_t> hashes((size_t)num_hashes * 32);
+    for (int lanes : MULTI_LANES) {
+        std::vector<uint8_t> msgs(lanes * 64);
+        std::vector<const uint8_t *> ptrs(lanes);
+        for (int l = 0; l < lanes; l++) ptrs[l] = &msgs[l * 64];
+        std::fill(hashes.begin(), hashes.end(), 0);
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t nonce = 0; nonce < (uint32_t)num_hashes; nonce += lanes) {
+            for (int l = 0; l < lanes; l++) make_message(&msgs[l * 64], base_len, nonce + l);
+            sha256_multi(ptrs.data(), base_len + 4, reinterpret_cast<uint8_t(*)[32]>(&hashes[(size_t)nonce * 32]),
+                         lanes);
+        }
+        auto end = std::chrono::steady_clock::now();
+        uint32_t mismatched = 0;
+        for (size_t n = 0; n < (size_t)num_hashes; n++) {
+            mismatched += std::memcmp(&hashes[n * 32], &reference[n * 32], 32) != 0;
+        }
+        // num_hashes is a multiple of every lane count, so every batch is full
+        std::memcpy(hash, &hashes[(size_t)(num_hashes - 1) * 32], 32);
+        ok &= report("multi", lanes, std::chrono::duration<double, std::milli>(end - start).count(), hash, expected,
+                     mismatched);
+    }
+    return ok ? 0 : 1;
+}
+
+// Impl mode: the standard loop on every transform this CPU supports. The
+// first row is the portable path, which all other rows are checked against.
+static constexpr sha256_impl IMPLS[] = {SHA256_IMPL_PORTABLE, SHA256_IMPL_SHANI, SHA256_IMPL_ARMV8};
+
+static int run_impl_comparison() {
+    sha256_impl detected = sha256_get_impl();
+    std::printf("=== Transform implementations: detected %s ===\n", sha256_impl_name(detected));
+    uint8_t hash[32];
+    char expected[65] = "";
+    bool ok = true;
+    for (sha256_impl impl : IMPLS) {
+        if (!sha256_set_impl(impl)) {
+            std::printf("skip mode=%s reason=not supported by this CPU or build\n", sha256_impl_name(impl));
+            continue;
+        }
+        double ms = time_scalar(hash);
+        if (impl == SHA256_IMPL_PORTABLE) hex(expected, hash);
+        ok &= report(sha256_impl_name(impl), 1, ms, hash, expected);
+    }
+    sha256_set_impl(detected);
+    return ok ? 0 : 1;
+}
+
+// Nonce mode: the standard loop vs the nonce-search API, which pads the
+// template once and starts each hash from the precomputed midstate. The
+// search row only serialises hashes that pass the zero-bit prefix filter;
+// its hit count and first hit are checked against a full scan.
+static constexpr unsigned NONCE_ZERO_BITS = 16;
+
+static int run_nonce_comparison(unsigned zero_bits) {
+    sha256_set_impl(SHA256_IMPL_PORTABLE);
+    size_t base_len = std::strlen((const char *)base_message);
+    SHA256_NONCE_CTX nctx;
+    sha256_nonce_init(&nctx, base_message, base_len);
+    std::printf("=== Nonce search: %d nonces, %zu byte prefix, %u zero bits, rounds 0-%u precomputed, "
+                "schedule words 16-%u precomputed ===\n",
+                num_hashes, base_len, zero_bits, nctx.nonce_word - 1, nctx.first_sched - 1);
+
+    uint8_t hash[32];
+    char expected[65];
+    double scalar_ms = time_scalar(hash);
+    hex(expected, hash);
+    bool ok = report("scalar", 1, scalar_ms, hash, expected);
+
+    uint32_t mask = zero_bits == 0 ? 0 : zero_bits >= 32 ? 0xffffffff : ~(0xffffffffu >> zero_bits);
+    uint32_t scan_hits = 0, scan_first = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t nonce = 0; nonce < (uint32_t)num_hashes; nonce++) {
+        sha256_nonce_hash(&nctx, nonce, hash);
+        uint32_t top = ((uint32_t)hash[0] << 24) | ((uint32_t)hash[1] << 16) | ((uint32_t)hash[2] << 8) | hash[3];
+        if ((top & mask) == 0 && scan_hits++ == 0) scan_first = nonce;
+    }
+    auto end = std::chrono::steady_clock::now();
+    ok &= report("nonce_hash", 1, std::chrono::duration<double, std::milli>(end - start).count(), hash, expected);
+
+    uint32_t first = 0;
+    uint8_t first_hash[32] = {0};
+    start = std::chrono::steady_clock::now();
+    uint32_t hits = sha256_nonce_search(&nctx, 0, num_hashes, zero_bits, &first, first_hash);
+    end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    char digest[65];
+    hex(digest, first_hash);
+    bool search_ok = hits == scan_hits && (hits == 0 || first == scan_first);
+    std::printf("mode=nonce_search zero_bits=%u elapsed_ms=%.3f hashes_per_sec=%.0f mh_per_sec=%.2f hits=%u "
+                "first_nonce=%u first_hash=%s status=%s\n",
+                zero_bits, ms, num_hashes / (ms / 1000.0), num_hashes / (ms / 1000.0) / 1e6, hits, first,
+                hits ? digest : "n/a", search_ok ? "OK" : "MISMATCH");
+    return ok && search_ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && std::strcmp(argv[1], "impl") == 0) {
+        return run_impl_comparison();
+    }
+    if (argc > 1 && std::strcmp(argv[1], "nonce") == 0) {
+        unsigned bits = argc > 2 ? (unsigned)std::strtoul(argv[2], nullptr, 10) : NONCE_ZERO_BITS;
+        return run_nonce_comparison(std::min(bits, 32u));
+    }
+    if (argc > 1 && std::strcmp(argv[1], "multi") == 0) {
+        return run_multi_comparison();
+    }
+    return run_standard();
+}
@@ -2,6 +2,20 @@
 #include <memory.h>
 #include "sha256.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define SHA256_HAVE_SHANI
+#define SHA256_HAVE_AVX
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || !defined(__clang__))
+/* GCC's arm_neon.h declares the SHA2 intrinsics for any target, so the path
+ * is built with a target attribute and chosen at run time. Clang before 16
+ * only declares them when the whole build targets the extension. */
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#define SHA256_HAVE_ARMV8
+#endif
+
 #define ROTLEFT(a,b) (((a) << (b)) | ((a) >> (32-(b))))
 #define ROTRIGHT(a,b) (((a) >> (b)) | ((a) << (32-(b))))
 
@@ -23,7 +37,7 @@ static const uint32_t k[64] = {
 	0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
 };
 
-void sha256_transform(SHA256_CTX *ctx, const uint8_t data[]) {
+static void transform_portable(uint32_t state[8], const uint8_t data[]) {
 	uint32_t a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
 
 	for (i = 0, j = 0; i < 16; ++i, j += 4)
@@ -31,8 +45,8 @@ void sha256_transform(SHA256_CTX *ctx, const uint8_t data[]) {
 	for ( ; i < 64; ++i)
 		m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
 
-	a = ctx->state[0]; b = ctx->state[1]; c = ctx->state[2]; d = ctx->state[3];
-	e = ctx->state[4]; f = ctx->state[5]; g = ctx->state[6]; h = ctx->state[7];
+	a = state[0]; b = state[1]; c = state[2]; d = state[3];
+	e = state[4]; f = state[5]; g = state[6]; h = state[7];
 
 	for (i = 0; i < 64; ++i) {
 		t1 = h + EP1(e) + CH(e, f, g) + k[i] + m[i];
@@ -40,8 +54,342 @@ void sha256_transform(SHA256_CTX *ctx, const uint8_t data[]) {
 		h = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2;
 	}
 
-	ctx->state[0] += a; ctx->state[1] += b; ctx->state[2] += c; ctx->state[3] += d;
-	ctx->state[4] += e; ctx->state[5] += f; ctx->state[6] += g; ctx->state[7] += h;
+	state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+	state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+#ifdef SHA256_HAVE_SHANI
+/* SHA-NI: sha256rnds2 runs two rounds on the state held as ABEF/CDGH
+ * halves, sha256msg1/msg2 extend the schedule four words at a time. Each
+ * loop step is four rounds on the message words in m[i % 4]. */
+__attribute__((target("sha,sse4.1")))
+static void transform_shani(uint32_t state[8], const uint8_t data[]) {
+	const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i state0, state1, abef, cdgh, tmp, wk, m[4];
+	int i;
+
+	tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1);  /* CDAB */
+	state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B);  /* EFGH */
+	state0 = _mm_alignr_epi8(tmp, state1, 8);  /* ABEF */
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0);  /* CDGH */
+	abef = state0; cdgh = state1;
+
+	for (i = 0; i < 16; ++i) {
+		if (i < 4) {
+			m[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16 * i)), mask);
+		} else {
+			/* w[t..t+3] = msg2(w[t-16..] + sig0(w[t-15..]) + w[t-7..], w[t-4..]) */
+			tmp = _mm_add_epi32(_mm_sha256msg1_epu32(m[i % 4], m[(i + 1) % 4]),
+				_mm_alignr_epi8(m[(i + 3) % 4], m[(i + 2) % 4], 4));
+			m[i % 4] = _mm_sha256msg2_epu32(tmp, m[(i + 3) % 4]);
+		}
+		wk = _mm_add_epi32(m[i % 4], _mm_loadu_si128((const __m128i *)&k[4 * i]));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0E));
+	}
+
+	state0 = _mm_add_epi32(state0, abef);
+	state1 = _mm_add_epi32(state1, cdgh);
+	tmp = _mm_shuffle_epi32(state0, 0x1B);  /* FEBA */
+	state1 = _mm_shuffle_epi32(state1, 0xB1);  /* DCHG */
+	_mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(tmp, state1, 0xF0));  /* DCBA */
+	_mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(state1, tmp, 8));  /* HGFE */
+}
+
+static int cpu_has_shani(void) {
+	unsigned eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & (1u << 19)) || !(ecx & (1u << 9)))
+		return 0;  /* SSE4.1, SSSE3 */
+	if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+		return 0;
+	return (ebx >> 29) & 1;
+}
+#endif
+
+#ifdef SHA256_HAVE_AVX
+/* AVX2 / AVX-512F: the CPUID leaf 7 feature bit, plus the OS saving the
+ * wider registers on a context switch (OSXSAVE, then the XCR0 state bits) */
+static int cpu_has_avx(unsigned leaf7_bit, unsigned xcr0_mask) {
+	unsigned eax, ebx, ecx, edx, lo, hi;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & (1u << 27)))
+		return 0;  /* OSXSAVE */
+	__asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+	if ((lo & xcr0_mask) != xcr0_mask)
+		return 0;
+	if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+		return 0;
+	return (ebx >> leaf7_bit) & 1;
+}
+#endif
+
+#ifdef SHA256_HAVE_ARMV8
+/* ARMv8 SHA2 extension: sha256h/sha256h2 run four rounds on the ABCD/EFGH
+ * halves, sha256su0/su1 extend the schedule four words at a time */
+#if !defined(__ARM_FEATURE_SHA2)
+__attribute__((target("+crypto")))
+#endif
+static void transform_armv8(uint32_t state[8], const uint8_t data[]) {
+	uint32x4_t state0 = vld1q_u32(&state[0]), state1 = vld1q_u32(&state[4]);
+	uint32x4_t abcd = state0, efgh = state1, tmp, wk, m[4];
+	int i;
+
+	for (i = 0; i < 4; ++i)
+		m[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+	for (i = 0; i < 16; ++i) {
+		wk = vaddq_u32(m[i % 4], vld1q_u32(&k[4 * i]));
+		if (i < 12)
+			m[i % 4] = vsha256su1q_u32(vsha256su0q_u32(m[i % 4], m[(i + 1) % 4]), m[(i + 2) % 4], m[(i + 3) % 4]);
+		tmp = state0;
+		state0 = vsha256hq_u32(state0, state1, wk);
+		state1 = vsha256h2q_u32(state1, tmp, wk);
+	}
+
+	vst1q_u32(&state[0], vaddq_u32(state0, abcd));
+	vst1q_u32(&state[4], vaddq_u32(state1, efgh));
+}
+#endif
+
+/* Runtime dispatch: a constructor picks SHA-NI before main when CPUID reports
+ * it, and sha256_set_impl() can change the choice later. The ARMv8 path has
+ * not been checked on hardware yet, so ARM stays on the portable transform
+ * unless it is selected explicitly (HWCAP decides whether it may be). The pointer is read and written with relaxed atomics
+ * (GCC builtins, so this file still builds as C and as C++), which keeps a
+ * switch while other threads hash free of data races. */
+typedef void (*transform_fn)(uint32_t state[8], const uint8_t data[]);
+
+static transform_fn transform = transform_portable;
+static int current_impl = SHA256_IMPL_PORTABLE;
+
+int sha256_impl_supported(sha256_impl impl) {
+	switch (impl) {
+	case SHA256_IMPL_PORTABLE: return 1;
+#ifdef SHA256_HAVE_SHANI
+	case SHA256_IMPL_SHANI: return cpu_has_shani();
+#endif
+#ifdef SHA256_HAVE_ARMV8
+	case SHA256_IMPL_ARMV8: return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#endif
+	default: return 0;
+	}
+}
+
+int sha256_set_impl(sha256_impl impl) {
+	if (!sha256_impl_supported(impl)) return 0;
+	transform_fn fn = transform_portable;
+	switch (impl) {
+#ifdef SHA256_HAVE_SHANI
+	case SHA256_IMPL_SHANI: fn = transform_shani; break;
+#endif
+#ifdef SHA256_HAVE_ARMV8
+	case SHA256_IMPL_ARMV8: fn = transform_armv8; break;
+#endif
+	default: break;
+	}
+	__atomic_store_n(&transform, fn, __ATOMIC_RELAXED);
+	__atomic_store_n(&current_impl, (int)impl, __ATOMIC_RELAXED);
+	return 1;
+}
+
+sha256_impl sha256_get_impl(void) {
+	return (sha256_impl)__atomic_load_n(&current_impl, __ATOMIC_RELAXED);
+}
+
+/* Multi-buffer widths with a wider instruction set behind them; see
+ * sha256_multi below */
+static int multi_avx2, multi_avx512;
+
+__attribute__((constructor)) static void detect_impl(void) {
+	sha256_set_impl(SHA256_IMPL_SHANI);
+#ifdef SHA256_HAVE_AVX
+	multi_avx2 = cpu_has_avx(5, 0x06);  /* XMM, YMM */
+	multi_avx512 = cpu_has_avx(16, 0xE6);  /* XMM, YMM, opmask, ZMM */
+#endif
+}
+
+const char *sha256_impl_name(sha256_impl impl) {
+	switch (impl) {
+	case SHA256_IMPL_SHANI: return "sha_ni";
+	case SHA256_IMPL_ARMV8: return "armv8_sha2";
+	default: return "portable";
+	}
+}
+
+void sha256_transform(SHA256_CTX *ctx, const uint8_t data[]) {
+	__atomic_load_n(&transform, __ATOMIC_RELAXED)(ctx->state, data);
+}
+
+/* Multi-buffer hashing: one independent message per vector lane, using the
+ * GCC/Clang vector extensions. Each width is built for the baseline target,
+ * where 4 lanes fit one SSE/NEON register and 8 or 16 lanes are split over
+ * several. On x86, 8 and 16 lanes are also built with AVX2 / AVX-512F target
+ * attributes and picked at run time. The round function is the scalar one
+ * above, applied to whole vectors. */
+typedef uint32_t sha256_v4 __attribute__((vector_size(16)));
+typedef uint32_t sha256_v8 __attribute__((vector_size(32)));
+typedef uint32_t sha256_v16 __attribute__((vector_size(64)));
+
+static const uint32_t h0[8] = {
+	0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19
+};
+
+static uint32_t load_be32(const uint8_t *p) {
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void store_be32(uint8_t *p, uint32_t v) {
+	p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+}
+
+/* Pads the last len % 64 bytes of a message into one or two blocks; returns
+ * the number of blocks */
+static size_t pad_tail(uint8_t tail[128], const uint8_t data[], size_t len) {
+	size_t rem = len % 64, blocks = rem < 56 ? 1 : 2, i;
+	uint64_t bitlen = (uint64_t)len * 8;
+	memcpy(tail, data + len - rem, rem);
+	tail[rem] = 0x80;
+	memset(tail + rem + 1, 0, blocks * 64 - rem - 1);
+	for (i = 0; i < 8; ++i) tail[blocks * 64 - 1 - i] = (uint8_t)(bitlen >> (8 * i));
+	return blocks;
+}
+
+#define SHA256_MULTI(name, N, vec, attr) \
+attr static void name(const uint8_t *const data[], size_t len, uint8_t hash[][32]) { \
+	vec state[8], m[64], zero = {0}, a, b, c, d, e, f, g, h, t1, t2; \
+	uint8_t tail[N][128]; \
+	size_t full = len / 64, blocks = full, blk; \
+	int i, lane; \
+	for (lane = 0; lane < N; ++lane) blocks = full + pad_tail(tail[lane], data[lane], len); \
+	for (i = 0; i < 8; ++i) state[i] = zero + h0[i]; \
+	for (blk = 0; blk < blocks; ++blk) { \
+		for (lane = 0; lane < N; ++lane) { \
+			const uint8_t *p = blk < full ? data[lane] + blk * 64 : tail[lane] + (blk - full) * 64; \
+			for (i = 0; i < 16; ++i) m[i][lane] = load_be32(p + 4 * i); \
+		} \
+		for (i = 16; i < 64; ++i) \
+			m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16]; \
+		a = state[0]; b = state[1]; c = state[2]; d = state[3]; \
+		e = state[4]; f = state[5]; g = state[6]; h = state[7]; \
+		for (i = 0; i < 64; ++i) { \
+			t1 = h + EP1(e) + CH(e, f, g) + k[i] + m[i]; \
+			t2 = EP0(a) + MAJ(a, b, c); \
+			h = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2; \
+		} \
+		state[0] += a; state[1] += b; state[2] += c; state[3] += d; \
+		state[4] += e; state[5] += f; state[6] += g; state[7] += h; \
+	} \
+	for (lane = 0; lane < N; ++lane) \
+		for (i = 0; i < 8; ++i) store_be32(hash[lane] + 4 * i, state[i][lane]); \
+}
+
+SHA256_MULTI(sha256_multi_x4, 4, sha256_v4, )
+SHA256_MULTI(sha256_multi_x8, 8, sha256_v8, )
+SHA256_MULTI(sha256_multi_x16, 16, sha256_v16, )
+#ifdef SHA256_HAVE_AVX
+SHA256_MULTI(sha256_multi_x8_avx2, 8, sha256_v8, __attribute__((target("avx2"))))
+SHA256_MULTI(sha256_multi_x16_avx512, 16, sha256_v16, __attribute__((target("avx512f"))))
+#endif
+
+void sha256_multi(const uint8_t *const data[], size_t len, uint8_t hash[][32], int lanes) {
+	SHA256_CTX ctx;
+	int i;
+	switch (lanes) {
+	case 4: sha256_multi_x4(data, len, hash); return;
+#ifdef SHA256_HAVE_AVX
+	case 8: (multi_avx2 ? sha256_multi_x8_avx2 : sha256_multi_x8)(data, len, hash); return;
+	case 16: (multi_avx512 ? sha256_multi_x16_avx512 : sha256_multi_x16)(data, len, hash); return;
+#else
+	case 8: sha256_multi_x8(data, len, hash); return;
+	case 16: sha256_multi_x16(data, len, hash); return;
+#endif
+	}
+	for (i = 0; i < lanes; ++i) {
+		sha256_init(&ctx);
+		sha256_update(&ctx, data[i], len);
+		sha256_final(&ctx, hash[i]);
+	}
+}
+
+/* Nonce search: the message is one block, prefix || nonce, and only the
+ * nonce words change. Rounds before the first nonce word and schedule words
+ * that never reach a nonce word are computed once in sha256_nonce_init. */
+int sha256_nonce_init(SHA256_NONCE_CTX *ctx, const uint8_t prefix[], size_t len) {
+	uint8_t block[64] = {0};
+	uint8_t var[64] = {0};
+	uint32_t a, b, c, d, e, f, g, h, i, t1, t2;
+	uint64_t bitlen = (uint64_t)(len + 4) * 8;
+
+	if (len > SHA256_NONCE_MAX_PREFIX) return 0;
+	memcpy(block, prefix, len);
+	block[len + 4] = 0x80;
+	for (i = 0; i < 8; ++i) block[63 - i] = (uint8_t)(bitlen >> (8 * i));
+
+	ctx->nonce_word = (uint32_t)len / 4;
+	ctx->nonce_shift = 8 * ((uint32_t)len % 4);
+	var[ctx->nonce_word] = 1;
+	if (ctx->nonce_shift) var[ctx->nonce_word + 1] = 1;
+	for (i = 0; i < 16; ++i) ctx->w[i] = load_be32(block + 4 * i);
+	ctx->first_sched = 64;
+	for (i = 16; i < 64; ++i) {
+		ctx->w[i] = SIG1(ctx->w[i - 2]) + ctx->w[i - 7] + SIG0(ctx->w[i - 15]) + ctx->w[i - 16];
+		var[i] = var[i - 2] | var[i - 7] | var[i - 15] | var[i - 16];
+		if (var[i] && ctx->first_sched == 64) ctx->first_sched = i;
+	}
+
+	a = h0[0]; b = h0[1]; c = h0[2]; d = h0[3];
+	e = h0[4]; f = h0[5]; g = h0[6]; h = h0[7];
+	for (i = 0; i < ctx->nonce_word; ++i) {
+		t1 = h + EP1(e) + CH(e, f, g) + k[i] + ctx->w[i];
+		t2 = EP0(a) + MAJ(a, b, c);
+		h = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2;
+	}
+	ctx->mid[0] = a; ctx->mid[1] = b; ctx->mid[2] = c; ctx->mid[3] = d;
+	ctx->mid[4] = e; ctx->mid[5] = f; ctx->mid[6] = g; ctx->mid[7] = h;
+	return 1;
+}
+
+static void nonce_state(const SHA256_NONCE_CTX *ctx, uint32_t nonce, uint32_t state[8]) {
+	uint32_t a, b, c, d, e, f, g, h, i, t1, t2, m[64];
+	uint32_t nw = ctx->nonce_word;
+
+	memcpy(m, ctx->w, ctx->first_sched * sizeof(uint32_t));
+	m[nw] |= nonce >> ctx->nonce_shift;
+	if (ctx->nonce_shift) m[nw + 1] |= nonce << (32 - ctx->nonce_shift);
+	for (i = ctx->first_sched; i < 64; ++i)
+		m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
+
+	a = ctx->mid[0]; b = ctx->mid[1]; c = ctx->mid[2]; d = ctx->mid[3];
+	e = ctx->mid[4]; f = ctx->mid[5]; g = ctx->mid[6]; h = ctx->mid[7];
+	for (i = nw; i < 64; ++i) {
+		t1 = h + EP1(e) + CH(e, f, g) + k[i] + m[i];
+		t2 = EP0(a) + MAJ(a, b, c);
+		h = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2;
+	}
+	state[0] = h0[0] + a; state[1] = h0[1] + b; state[2] = h0[2] + c; state[3] = h0[3] + d;
+	state[4] = h0[4] + e; state[5] = h0[5] + f; state[6] = h0[6] + g; state[7] = h0[7] + h;
+}
+
+void sha256_nonce_hash(const SHA256_NONCE_CTX *ctx, uint32_t nonce, uint8_t hash[32]) {
+	uint32_t state[8];
+	int i;
+	nonce_state(ctx, nonce, state);
+	for (i = 0; i < 8; ++i) store_be32(hash + 4 * i, state[i]);
+}
+
+uint32_t sha256_nonce_search(const SHA256_NONCE_CTX *ctx, uint32_t start, uint32_t count, unsigned zero_bits,
+	uint32_t *first, uint8_t hash[32]) {
+	/* The first 32 bits of the hash are state[0], so the filter never
+	 * serialises a digest that fails it */
+	uint32_t mask = zero_bits == 0 ? 0 : zero_bits >= 32 ? 0xffffffff : ~(0xffffffffu >> zero_bits);
+	uint32_t state[8], hits = 0, n;
+	for (n = 0; n < count; ++n) {
+		nonce_state(ctx, start + n, state);
+		if (state[0] & mask) continue;
+		if (hits++ == 0) {
+			*first = start + n;
+			sha256_nonce_hash(ctx, start + n, hash);
+		}
+	}
+	return hits;
 }
 
 void sha256_init(SHA256_CTX *ctx) {
@@ -15,4 +15,46 @@ void sha256_init(SHA256_CTX *ctx);
 void sha256_update(SHA256_CTX *ctx, const uint8_t data[], size_t len);
 void sha256_final(SHA256_CTX *ctx, uint8_t hash[]);
 
+/* Block transform implementations. At startup the library picks SHA-NI when
+ * the CPU has it and portable otherwise (ARMv8 is opt-in); sha256_set_impl()
+ * overrides that choice and returns 0 (leaving it unchanged) when the CPU or
+ * build lacks `impl`. */
+typedef enum {
+    SHA256_IMPL_PORTABLE,
+    SHA256_IMPL_SHANI,  /* x86 SHA extensions */
+    SHA256_IMPL_ARMV8   /* ARMv8 SHA2 crypto extension */
+} sha256_impl;
+
+int sha256_impl_supported(sha256_impl impl);
+int sha256_set_impl(sha256_impl impl);
+sha256_impl sha256_get_impl(void);
+const char *sha256_impl_name(sha256_impl impl);
+
+/* Hashes `lanes` messages of the same length at once, one per SIMD lane.
+ * lanes: 4, 8 or 16; any other count is hashed one message at a time.
+ * Results are identical to sha256_init/update/final on each message. */
+void sha256_multi(const uint8_t *const data[], size_t len, uint8_t hash[][32], int lanes);
+
+/* Nonce search over one-block messages prefix || nonce (nonce big-endian,
+ * prefix at most 51 bytes). Init pads the template once and precomputes the
+ * rounds before the nonce and the schedule words that do not depend on it. */
+#define SHA256_NONCE_MAX_PREFIX 51
+
+typedef struct {
+    uint32_t w[64];        /* Schedule with zero nonce; exact below first_sched */
+    uint32_t mid[8];       /* a..h after rounds 0 .. nonce_word - 1 */
+    uint32_t nonce_word;   /* First message word holding nonce bits */
+    uint32_t nonce_shift;  /* Bit offset of the nonce within that word */
+    uint32_t first_sched;  /* First schedule word that depends on the nonce */
+} SHA256_NONCE_CTX;
+
+int sha256_nonce_init(SHA256_NONCE_CTX *ctx, const uint8_t prefix[], size_t len);
+void sha256_nonce_hash(const SHA256_NONCE_CTX *ctx, uint32_t nonce, uint8_t hash[32]);
+
+/* Hashes nonces start .. start + count - 1 and returns how many hashes start
+ * with at least zero_bits (0-32) zero bits; the first such nonce and its hash
+ * are stored in *first and hash */
+uint32_t sha256_nonce_search(const SHA256_NONCE_CTX *ctx, uint32_t start, uint32_t count, unsigned zero_bits,
+                             uint32_t *first, uint8_t hash[32]);
+
 #endif